@@ -0,0 +1,149 @@
+function [iqData, meta] = BytePipe_WavformBinFileRead( filename )
+% Read a BytePipe binary IQ file (.iq) or compressed binary IQ file (.iqz).
+% iqData holds the int16 sample values as returned by
+% BytePipe_WavformFileRead, meta holds the header.  Compressed files are
+% decoded one block at a time as they are read.
+
+fid = fopen(filename,'r');
+if fid < 0
+    error('Unable to open %s', filename);
+end
+cleanup = onCleanup(@() fclose(fid));
+
+hdr = fread(fid, 64, '*uint8')';
+if numel(hdr) < 64 || typecast(hdr(1:4),'uint32') ~= hex2dec('51495042')
+    error('%s is not a binary IQ file', filename);
+end
+
+meta.Version        = double(typecast(hdr(5:6),'uint16'));
+headerSize          = double(typecast(hdr(7:8),'uint16'));
+format              = typecast(hdr(9:12),'uint32');
+meta.SampleRate     = double(typecast(hdr(13:16),'uint32'));
+meta.CarrierFreq    = double(typecast(hdr(17:24),'uint64'));
+meta.Port           = double(typecast(hdr(25:28),'uint32'));
+meta.TimestampFreq  = double(typecast(hdr(29:32),'uint32'));
+meta.StartTimestamp = typecast(hdr(33:40),'uint64');
+sampleCnt           = double(typecast(hdr(41:48),'uint64'));
+dataSize            = double(typecast(hdr(49:52),'uint32'));
+dataCrc             = typecast(hdr(57:60),'uint32');
+headerCrc           = typecast(hdr(61:64),'uint32');
+
+if meta.Version ~= 1 || headerSize ~= 64 || (format ~= 1 && format ~= 2)
+    error('%s has an unsupported version or format', filename);
+end
+if headerCrc ~= crc32(hdr(1:60))
+    error('%s header CRC error', filename);
+end
+
+fseek(fid, headerSize, 'bof');
+
+if format == 2
+    iq = riceDecode(fid, dataSize, sampleCnt, dataCrc, filename);
+    iqData = iq(1,:)' + 1i*iq(2,:)';
+    return;
+end
+
+data = fread(fid, 4*sampleCnt, '*uint8');
+if numel(data) ~= 4*sampleCnt
+    error('%s is truncated', filename);
+end
+if dataCrc ~= crc32(data)
+    error('%s data CRC error', filename);
+end
+
+iq = reshape(typecast(data,'int16'), 2, []);
+iqData = double(iq(1,:)') + 1i*double(iq(2,:)');
+
+end
+
+function iq = riceDecode( fid, dataSize, sampleCnt, dataCrc, filename )
+% Decode the Rice coded blocks of a compressed file, see iq_rice.h
+blockSamples = 1024;
+iq = zeros(2, sampleCnt);
+c = java.util.zip.CRC32;
+used = 0;
+
+for first = 1:blockSamples:sampleCnt
+    n = min(blockSamples, sampleCnt - first + 1);
+
+    blkHdr = fread(fid, 4, '*uint8')';
+    if numel(blkHdr) ~= 4
+        error('%s is truncated', filename);
+    end
+    payloadSize = double(typecast(blkHdr(1:2),'uint16'));
+    payload = fread(fid, payloadSize, '*uint8')';
+    if numel(payload) ~= payloadSize
+        error('%s is truncated', filename);
+    end
+    c.update(typecast([blkHdr payload],'int8'));
+    used = used + 4 + payloadSize;
+
+    % Payload bits, MSB of each byte first
+    bits = reshape(dec2bin(payload, 8).', 1, []) == '1';
+    pos = 1;
+
+    for ch = 1:2
+        mode  = double(blkHdr(2 + ch));
+        order = bitshift(mode, -5);
+        k     = bitand(mode, 31);
+        if order > 2 || k > 16
+            error('%s block at sample %d is corrupt', filename, first);
+        end
+
+        u = zeros(1, n);
+        for i = 1:n
+            if k == 16
+                u(i) = bitsToNum(bits(pos:pos+15));
+                pos = pos + 16;
+            else
+                q = 0;
+                while q < 16 && bits(pos)
+                    q = q + 1;
+                    pos = pos + 1;
+                end
+                if q < 16
+                    u(i) = q*2^k + bitsToNum(bits(pos+1:pos+k));
+                    pos = pos + 1 + k;
+                else
+                    u(i) = bitsToNum(bits(pos:pos+15));
+                    pos = pos + 16;
+                end
+            end
+        end
+
+        % 0, 1, 2, 3, 4 ... -> 0, -1, 1, -2, 2 ...
+        r = u/2;
+        odd = mod(u, 2) == 1;
+        r(odd) = -(u(odd) + 1)/2;
+
+        % Undo the predictor, the sums wrap to 16 bits as in the firmware
+        for o = 1:order
+            r = cumsum(r);
+        end
+        iq(ch, first:first+n-1) = mod(r + 32768, 65536) - 32768;
+    end
+
+    if numel(bits) - (pos - 1) >= 8
+        error('%s block at sample %d is corrupt', filename, first);
+    end
+end
+
+if used ~= dataSize
+    error('%s is truncated', filename);
+end
+if dataCrc ~= uint32(c.getValue())
+    error('%s data CRC error', filename);
+end
+
+end
+
+function v = bitsToNum( b )
+v = sum(b .* 2.^(numel(b)-1:-1:0));
+end
+
+function crc = crc32( bytes )
+% CRC-32 as used by zlib, matches the firmware
+c = java.util.zip.CRC32;
+c.update(typecast(bytes(:),'int8'));
+crc = uint32(c.getValue());
+end
@@ -0,0 +1,50 @@
+function BytePipe_WavformBinFileWrite( filename, iqData, meta )
+% Write a BytePipe binary IQ file (.iq).  iqData is scaled as for
+% BytePipe_WavformFileWrite, full scale is +/-1.  meta is optional and may
+% set SampleRate, CarrierFreq, Port, TimestampFreq and StartTimestamp,
+% missing fields are written as zero (unknown).
+
+if nargin < 3
+    meta = struct();
+end
+fields = {'SampleRate','CarrierFreq','Port','TimestampFreq','StartTimestamp'};
+for k = 1:numel(fields)
+    if ~isfield(meta, fields{k})
+        meta.(fields{k}) = 0;
+    end
+end
+
+iq = [int16(real(iqData(:)).'*32768); int16(imag(iqData(:)).'*32768)];
+data = typecast(iq(:),'uint8');
+
+hdr = [typecast(uint32(hex2dec('51495042')),'uint8'), ...
+       typecast(uint16(1),'uint8'), ...
+       typecast(uint16(64),'uint8'), ...
+       typecast(uint32(1),'uint8'), ...
+       typecast(uint32(meta.SampleRate),'uint8'), ...
+       typecast(uint64(meta.CarrierFreq),'uint8'), ...
+       typecast(uint32(meta.Port),'uint8'), ...
+       typecast(uint32(meta.TimestampFreq),'uint8'), ...
+       typecast(uint64(meta.StartTimestamp),'uint8'), ...
+       typecast(uint64(numel(iqData)),'uint8'), ...
+       typecast(uint32(numel(data)),'uint8'), ...
+       zeros(1,4,'uint8'), ...
+       typecast(crc32(data),'uint8')];
+hdr = [hdr, typecast(crc32(hdr),'uint8')];
+
+fid = fopen(filename,'w');
+if fid < 0
+    error('Unable to create %s', filename);
+end
+fwrite(fid, hdr, 'uint8');
+fwrite(fid, data, 'uint8');
+fclose(fid);
+
+end
+
+function crc = crc32( bytes )
+% CRC-32 as used by zlib, matches the firmware
+c = java.util.zip.CRC32;
+c.update(typecast(bytes(:),'int8'));
+crc = uint32(c.getValue());
+end
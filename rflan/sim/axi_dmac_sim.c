@@ -0,0 +1,438 @@
+/***************************************************************************//**
+*  \addtogroup AXI_DMAC_SIM
+*   @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       axi_dmac_sim.c
+*
+*  \details    This file contains the AXI DMAC model.  Time advances in steps
+*              that end at the next transfer completion so interrupts are
+*              raised at the tick they would occur on hardware.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "axi_dmac_sim.h"
+#include "axi_dmac.h"
+#include "util.h"
+#include "timestamp.h"
+#include "sim_port.h"
+#include "error.h"
+
+#define AXI_DMAC_SIM_VERSION        (0x00040462)  ///< Reported core version
+#define AXI_DMAC_SIM_REG_VERSION    (0x000)
+#define AXI_DMAC_SIM_REG_ACTIVE_ID  (0x42c)
+#define AXI_DMAC_SIM_REG_PROGRESS   (0x448)
+#define AXI_DMAC_SIM_FLAG_CYCLIC    (0x1)
+#define AXI_DMAC_SIM_ID_MASK        (0x3)
+
+/**
+**  AXI DMAC Simulation Request
+*/
+typedef struct
+{
+  uint32_t              Address;        ///< Address of the first row
+  uint32_t              XLength;        ///< Row size less one
+  uint32_t              YLength;        ///< Row count less one
+  uint32_t              Stride;         ///< Bytes between row starts
+  uint32_t              Flags;          ///< Transfer flags
+  uint32_t              Id;             ///< Transfer ID
+} axi_dmac_sim_req_t;
+
+/**
+**  AXI DMAC Simulation Instance
+*/
+typedef struct
+{
+  bool                  Used;           ///< Instance created
+  axi_dmac_sim_cfg_t    Cfg;            ///< Configuration
+  uint32_t              XMask;          ///< Writable X_LENGTH bits
+  uint32_t              YMask;          ///< Writable Y_LENGTH bits
+  uint32_t              HighMask;       ///< Writable ADDRESS_HIGH bits
+  uint32_t              Ctrl;           ///< CTRL register
+  uint32_t              IrqMask;        ///< IRQ_MASK register
+  uint32_t              IrqPending;     ///< IRQ_PENDING register
+  uint32_t              Regs[0x100];    ///< Staged request registers from 0x400
+  bool                  StartPending;   ///< START_TRANSFER reads one
+  uint32_t              NextId;         ///< TRANSFER_ID register
+  uint32_t              DoneMask;       ///< TRANSFER_DONE register
+  axi_dmac_sim_req_t    Queue[AXI_DMAC_SIM_QUEUE_MAX]; ///< Accepted transfers, Head is active
+  uint32_t              Head;           ///< Index of active transfer
+  uint32_t              Count;          ///< Number of accepted transfers
+  uint64_t              Progress;       ///< Active transfer progress in bytes times TIMESTAMP_FREQ_HZ
+  uint32_t              RowsDone;       ///< Rows of the active transfer passed to the data callback
+  axi_dmac_sim_stats_t  Stats;          ///< Statistics
+} axi_dmac_sim_t;
+
+static axi_dmac_sim_t   AxiDmacSim[AXI_DMAC_SIM_MAX_INSTANCES];
+static uint64_t         AxiDmacSimTime;
+static uint32_t         AxiDmacSimAccessCost;
+
+#define AXI_DMAC_SIM_REG(s, offset)   ((s)->Regs[((offset) - AXI_DMAC_REG_CTRL) >> 2])
+
+static axi_dmac_sim_t *AxiDmacSim_Find( uint32_t Base )
+{
+  for( int i = 0; i < AXI_DMAC_SIM_MAX_INSTANCES; i++ )
+  {
+    if( AxiDmacSim[i].Used && (AxiDmacSim[i].Cfg.Base == Base) )
+      return &AxiDmacSim[i];
+  }
+
+  return NULL;
+}
+
+static void AxiDmacSim_UpdateIrq( axi_dmac_sim_t *Sim )
+{
+  SimPort_SetIrqLevel( Sim->Cfg.IrqId, (Sim->IrqPending & ~Sim->IrqMask) != 0 );
+}
+
+static uint64_t AxiDmacSim_Size( const axi_dmac_sim_req_t *Req )
+{
+  return (uint64_t)(Req->XLength + 1) * (Req->YLength + 1);
+}
+
+/* Take the staged request into the queue if there is room */
+static void AxiDmacSim_Accept( axi_dmac_sim_t *Sim )
+{
+  if( !Sim->StartPending || !(Sim->Ctrl & AXI_DMAC_CTRL_ENABLE) || (Sim->Count >= Sim->Cfg.QueueDepth) )
+    return;
+
+  axi_dmac_sim_req_t *Req = &Sim->Queue[ (Sim->Head + Sim->Count) % AXI_DMAC_SIM_QUEUE_MAX ];
+  bool ToMem = (Sim->Cfg.Direction == DMA_DEV_TO_MEM);
+
+  Req->Address = AXI_DMAC_SIM_REG( Sim, ToMem ? AXI_DMAC_REG_DEST_ADDRESS : AXI_DMAC_REG_SRC_ADDRESS );
+  Req->Stride  = AXI_DMAC_SIM_REG( Sim, ToMem ? AXI_DMAC_REG_DEST_STRIDE : AXI_DMAC_REG_SRC_STRIDE );
+  Req->XLength = AXI_DMAC_SIM_REG( Sim, AXI_DMAC_REG_X_LENGTH );
+  Req->YLength = AXI_DMAC_SIM_REG( Sim, AXI_DMAC_REG_Y_LENGTH );
+  Req->Flags   = AXI_DMAC_SIM_REG( Sim, AXI_DMAC_REG_FLAGS );
+  Req->Id      = Sim->NextId;
+
+  /* Reusing an ID clears its done bit */
+  Sim->DoneMask &= ~(1u << Req->Id);
+  Sim->NextId = (Sim->NextId + 1) & AXI_DMAC_SIM_ID_MASK;
+
+  if( Sim->Count == 0 )
+  {
+    Sim->Progress = 0;
+    Sim->RowsDone = 0;
+  }
+
+  Sim->Count++;
+  Sim->StartPending = false;
+  Sim->IrqPending |= AXI_DMAC_IRQ_SOT;
+  Sim->Stats.SubmitCnt++;
+}
+
+/* Pass rows completed so far to the data callback */
+static void AxiDmacSim_Rows( axi_dmac_sim_t *Sim, axi_dmac_sim_req_t *Req, uint64_t Bytes )
+{
+  uint32_t Row = Req->XLength + 1;
+  uint32_t Stride = (Req->YLength > 0) ? Req->Stride : Row;
+
+  while( ((uint64_t)(Sim->RowsDone + 1) * Row) <= Bytes )
+  {
+    if( Sim->Cfg.Data != NULL )
+      Sim->Cfg.Data( Req->Address + Sim->RowsDone * Stride, Row, Sim->Cfg.DataRef );
+
+    Sim->RowsDone++;
+  }
+}
+
+/* Complete the active transfer once all its bytes have moved */
+static void AxiDmacSim_Complete( axi_dmac_sim_t *Sim )
+{
+  while( Sim->Count > 0 )
+  {
+    axi_dmac_sim_req_t *Req = &Sim->Queue[ Sim->Head ];
+    uint64_t Size = AxiDmacSim_Size( Req );
+
+    AxiDmacSim_Rows( Sim, Req, Sim->Progress / TIMESTAMP_FREQ_HZ );
+
+    if( Sim->Progress < Size * TIMESTAMP_FREQ_HZ )
+      break;
+
+    Sim->Stats.ByteCnt += Size;
+    Sim->IrqPending |= AXI_DMAC_IRQ_EOT;
+    Sim->Progress = 0;
+    Sim->RowsDone = 0;
+
+    /* Cyclic transfers repeat until the core is disabled */
+    if( Req->Flags & AXI_DMAC_SIM_FLAG_CYCLIC )
+    {
+      Sim->Stats.CyclicCnt++;
+      break;
+    }
+
+    Sim->DoneMask |= 1u << Req->Id;
+    Sim->Head = (Sim->Head + 1) % AXI_DMAC_SIM_QUEUE_MAX;
+    Sim->Count--;
+    Sim->Stats.CompleteCnt++;
+
+    AxiDmacSim_Accept( Sim );
+
+    if( Sim->Count == 0 )
+      Sim->Stats.StarveCnt++;
+  }
+}
+
+static void AxiDmacSim_Disable( axi_dmac_sim_t *Sim )
+{
+  Sim->Count = 0;
+  Sim->Head = 0;
+  Sim->Progress = 0;
+  Sim->RowsDone = 0;
+  Sim->StartPending = false;
+  Sim->NextId = 0;
+  Sim->DoneMask = 0;
+}
+
+static void AxiDmacSim_Charge( void )
+{
+  if( AxiDmacSimAccessCost > 0 )
+    AxiDmacSim_Advance( AxiDmacSimAccessCost );
+}
+
+int32_t AxiDmacSim_Read( uint32_t Base, uint32_t Offset, uint32_t *Data )
+{
+  axi_dmac_sim_t *Sim = AxiDmacSim_Find( Base );
+
+  if( Sim == NULL )
+    return FAILURE;
+
+  AxiDmacSim_Charge( );
+
+  Sim->Stats.RegReadCnt++;
+
+  switch( Offset )
+  {
+    case AXI_DMAC_SIM_REG_VERSION:      *Data = AXI_DMAC_SIM_VERSION; break;
+    case AXI_DMAC_REG_IRQ_MASK:         *Data = Sim->IrqMask; break;
+    case AXI_DMAC_REG_IRQ_PENDING:      *Data = Sim->IrqPending; break;
+    case AXI_DMAC_REG_CTRL:             *Data = Sim->Ctrl; break;
+    case AXI_DMAC_REG_TRANSFER_ID:      *Data = Sim->NextId; break;
+    case AXI_DMAC_REG_START_TRANSFER:   *Data = Sim->StartPending ? 1 : 0; break;
+    case AXI_DMAC_REG_TRANSFER_DONE:    *Data = Sim->DoneMask; break;
+    case AXI_DMAC_SIM_REG_ACTIVE_ID:    *Data = Sim->Queue[ Sim->Head ].Id; break;
+    case AXI_DMAC_SIM_REG_PROGRESS:     *Data = (Sim->Count > 0) ? (uint32_t)(Sim->Progress / TIMESTAMP_FREQ_HZ) : 0; break;
+    default:
+      if( ((Offset >= AXI_DMAC_REG_CTRL) && (Offset <= AXI_DMAC_REG_SRC_STRIDE)) ||
+          (Offset == AXI_DMAC_REG_DEST_ADDRESS_HIGH) || (Offset == AXI_DMAC_REG_SRC_ADDRESS_HIGH) )
+        *Data = AXI_DMAC_SIM_REG( Sim, Offset );
+      else
+        *Data = 0;
+      break;
+  }
+
+  return SUCCESS;
+}
+
+int32_t AxiDmacSim_Write( uint32_t Base, uint32_t Offset, uint32_t Data )
+{
+  axi_dmac_sim_t *Sim = AxiDmacSim_Find( Base );
+
+  if( Sim == NULL )
+    return FAILURE;
+
+  AxiDmacSim_Charge( );
+
+  Sim->Stats.RegWriteCnt++;
+
+  switch( Offset )
+  {
+    case AXI_DMAC_REG_IRQ_MASK:
+      Sim->IrqMask = Data & (AXI_DMAC_IRQ_SOT | AXI_DMAC_IRQ_EOT);
+      break;
+
+    case AXI_DMAC_REG_IRQ_PENDING:
+      Sim->IrqPending &= ~Data;
+      break;
+
+    case AXI_DMAC_REG_CTRL:
+      Sim->Ctrl = Data & (AXI_DMAC_CTRL_ENABLE | AXI_DMAC_CTRL_PAUSE);
+
+      /* Disabling flushes the queue and restarts transfer IDs */
+      if( !(Sim->Ctrl & AXI_DMAC_CTRL_ENABLE) )
+        AxiDmacSim_Disable( Sim );
+      break;
+
+    case AXI_DMAC_REG_START_TRANSFER:
+      if( (Data & 1) && (Sim->Ctrl & AXI_DMAC_CTRL_ENABLE) )
+      {
+        Sim->StartPending = true;
+        AxiDmacSim_Accept( Sim );
+      }
+      break;
+
+    case AXI_DMAC_REG_X_LENGTH:
+      AXI_DMAC_SIM_REG( Sim, Offset ) = Data & Sim->XMask;
+      break;
+
+    case AXI_DMAC_REG_Y_LENGTH:
+      AXI_DMAC_SIM_REG( Sim, Offset ) = Data & Sim->YMask;
+      break;
+
+    case AXI_DMAC_REG_DEST_ADDRESS_HIGH:
+    case AXI_DMAC_REG_SRC_ADDRESS_HIGH:
+      AXI_DMAC_SIM_REG( Sim, Offset ) = Data & Sim->HighMask;
+      break;
+
+    case AXI_DMAC_REG_FLAGS:
+    case AXI_DMAC_REG_DEST_ADDRESS:
+    case AXI_DMAC_REG_SRC_ADDRESS:
+    case AXI_DMAC_REG_DEST_STRIDE:
+    case AXI_DMAC_REG_SRC_STRIDE:
+      AXI_DMAC_SIM_REG( Sim, Offset ) = Data;
+      break;
+
+    default:
+      break;
+  }
+
+  AxiDmacSim_UpdateIrq( Sim );
+
+  return SUCCESS;
+}
+
+void AxiDmacSim_Advance( uint64_t Ticks )
+{
+  uint64_t End = AxiDmacSimTime + Ticks;
+
+  /* Interrupt handlers may advance the clock further while this loop runs */
+  while( AxiDmacSimTime < End )
+  {
+    uint64_t Step = End - AxiDmacSimTime;
+
+    /* Stop at the next transfer completion */
+    for( int i = 0; i < AXI_DMAC_SIM_MAX_INSTANCES; i++ )
+    {
+      axi_dmac_sim_t *Sim = &AxiDmacSim[i];
+
+      if( Sim->Used && (Sim->Count > 0) && !(Sim->Ctrl & AXI_DMAC_CTRL_PAUSE) && (Sim->Cfg.ByteRate > 0) )
+      {
+        uint64_t Remain = AxiDmacSim_Size( &Sim->Queue[ Sim->Head ] ) * TIMESTAMP_FREQ_HZ - Sim->Progress;
+        uint64_t Need = (Remain + Sim->Cfg.ByteRate - 1) / Sim->Cfg.ByteRate;
+
+        if( Need < Step )
+          Step = Need;
+      }
+    }
+
+    if( Step == 0 )
+      Step = 1;
+
+    AxiDmacSimTime += Step;
+
+    for( int i = 0; i < AXI_DMAC_SIM_MAX_INSTANCES; i++ )
+    {
+      axi_dmac_sim_t *Sim = &AxiDmacSim[i];
+
+      if( !Sim->Used || !(Sim->Ctrl & AXI_DMAC_CTRL_ENABLE) )
+        continue;
+
+      if( Sim->Count == 0 )
+      {
+        Sim->Stats.IdleTicks += Step;
+      }
+      else if( !(Sim->Ctrl & AXI_DMAC_CTRL_PAUSE) )
+      {
+        Sim->Progress += Step * Sim->Cfg.ByteRate;
+        AxiDmacSim_Complete( Sim );
+      }
+    }
+
+    /* Raise interrupts, handlers run from here */
+    for( int i = 0; i < AXI_DMAC_SIM_MAX_INSTANCES; i++ )
+    {
+      if( AxiDmacSim[i].Used )
+        AxiDmacSim_UpdateIrq( &AxiDmacSim[i] );
+    }
+  }
+}
+
+uint64_t AxiDmacSim_GetTime( void )
+{
+  return AxiDmacSimTime;
+}
+
+void AxiDmacSim_SetAccessCost( uint32_t Ticks )
+{
+  AxiDmacSimAccessCost = Ticks;
+}
+
+int32_t AxiDmacSim_GetStats( uint32_t Base, axi_dmac_sim_stats_t *Stats )
+{
+  axi_dmac_sim_t *Sim = AxiDmacSim_Find( Base );
+
+  if( (Sim == NULL) || (Stats == NULL) )
+    return FAILURE;
+
+  *Stats = Sim->Stats;
+  Stats->IrqCnt = SimPort_GetIrqCnt( Sim->Cfg.IrqId );
+
+  return SUCCESS;
+}
+
+int32_t AxiDmacSim_Create( const axi_dmac_sim_cfg_t *Cfg )
+{
+  if( (Cfg == NULL) || (Cfg->XLengthBits == 0) || (Cfg->XLengthBits > 32) || (Cfg->YLengthBits > 32) || (Cfg->AddressBits > 64) ||
+      (Cfg->QueueDepth == 0) || (Cfg->QueueDepth > AXI_DMAC_SIM_QUEUE_MAX) || (AxiDmacSim_Find( Cfg->Base ) != NULL) )
+    return FAILURE;
+
+  for( int i = 0; i < AXI_DMAC_SIM_MAX_INSTANCES; i++ )
+  {
+    axi_dmac_sim_t *Sim = &AxiDmacSim[i];
+
+    if( !Sim->Used )
+    {
+      memset( Sim, 0, sizeof(*Sim) );
+      Sim->Cfg = *Cfg;
+      Sim->XMask = (Cfg->XLengthBits == 32) ? UINT32_MAX : ((1u << Cfg->XLengthBits) - 1);
+      Sim->YMask = (Cfg->YLengthBits == 32) ? UINT32_MAX : ((1u << Cfg->YLengthBits) - 1);
+      Sim->HighMask = (Cfg->AddressBits <= 32) ? 0 : (Cfg->AddressBits >= 64) ? UINT32_MAX : ((1u << (Cfg->AddressBits - 32)) - 1);
+      Sim->IrqMask = AXI_DMAC_IRQ_SOT | AXI_DMAC_IRQ_EOT;
+      Sim->Used = true;
+      return SUCCESS;
+    }
+  }
+
+  return FAILURE;
+}
+
+void AxiDmacSim_Reset( void )
+{
+  memset( AxiDmacSim, 0, sizeof(AxiDmacSim) );
+  AxiDmacSimTime = 0;
+  AxiDmacSimAccessCost = 0;
+}
@@ -0,0 +1,221 @@
+#ifndef AXI_DMAC_SIM_H_
+#define AXI_DMAC_SIM_H_
+/***************************************************************************//**
+*  \defgroup   AXI_DMAC_SIM AXI DMAC Simulation
+*  @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       axi_dmac_sim.h
+*
+*  \details
+*
+*  This file contains a host model of the AXI DMAC register map used to run
+*  csl/axi_dmac.c on a build machine.  Register accesses made through
+*  axi_io_read and axi_io_write are routed to the model by base address.  The
+*  model implements CTRL, IRQ_MASK, IRQ_PENDING, TRANSFER_ID, START_TRANSFER,
+*  FLAGS, the address including ADDRESS_HIGH, length and stride registers, TRANSFER_DONE, the
+*  transfer queue and cyclic transfers.  A simulated clock in TIMESTAMP_FREQ_HZ
+*  ticks moves bytes at the configured rate and raises SOT and EOT interrupts
+*  through the handler connected with XScuGic_Connect.
+*
+*  The clock only moves in AxiDmacSim_Advance, while a shimmed semaphore wait
+*  is blocked and, if AxiDmacSim_SetAccessCost is used, on every register
+*  access so driver overhead shows up as inter-transfer gaps.
+*
+*  A host build compiles the driver and timestamp sources unchanged against
+*  the shim headers in sim/include, for example
+*
+*    gcc -Isim/include -Isim -Isrc/csl -Isrc/lib src/csl/axi_dmac.c
+*        src/lib/timestamp.c src/lib/mem_pool.c sim/axi_dmac_sim.c
+*        sim/axi_io_sim.c sim/sim_port.c <test>.c
+*
+*  The regression test in axi_dmac_sim_test.c is built and run with
+*  "make test" in the sim directory.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "axi_dmac.h"
+
+#define AXI_DMAC_SIM_MAX_INSTANCES  (AXI_DMAC_MAX_INSTANCES)  ///< Number of models that can be created
+#define AXI_DMAC_SIM_QUEUE_MAX      (4)                       ///< Transfers the core can hold, one per transfer ID
+
+/**
+**  AXI DMAC Simulation Data Callback
+**
+**  Called for every row moved so a test can produce or check samples.
+*/
+typedef void (*axi_dmac_sim_data_t)( uint32_t Address, uint32_t Size, void *Ref );
+
+/**
+**  AXI DMAC Simulation Configuration
+*/
+typedef struct
+{
+  uint32_t              Base;           ///< Register base address
+  uint32_t              IrqId;          ///< Interrupt ID the driver connects
+  axi_dmac_direction_t  Direction;      ///< Transfer direction of the core
+  uint32_t              XLengthBits;    ///< Width of X_LENGTH
+  uint32_t              YLengthBits;    ///< Width of Y_LENGTH, 0 = core built without 2D support
+  uint32_t              AddressBits;    ///< Width of the memory address, 32 or less = no ADDRESS_HIGH
+  uint32_t              QueueDepth;     ///< Transfers accepted including the active one, 1 to AXI_DMAC_SIM_QUEUE_MAX
+  uint32_t              ByteRate;       ///< Bytes per second, sample rate times 4 for IQ data
+  axi_dmac_sim_data_t   Data;           ///< Row callback, NULL = timing only
+  void                 *DataRef;        ///< Row callback reference
+} axi_dmac_sim_cfg_t;
+
+/**
+**  AXI DMAC Simulation Statistics
+*/
+typedef struct
+{
+  uint32_t              RegReadCnt;     ///< Register reads
+  uint32_t              RegWriteCnt;    ///< Register writes
+  uint32_t              IrqCnt;         ///< Interrupt handler invocations
+  uint32_t              SubmitCnt;      ///< Transfers accepted by the core
+  uint32_t              CompleteCnt;    ///< Transfers completed
+  uint32_t              CyclicCnt;      ///< Cyclic transfer repetitions
+  uint32_t              StarveCnt;      ///< Times the queue ran empty with the core enabled
+  uint64_t              ByteCnt;        ///< Bytes moved
+  uint64_t              IdleTicks;      ///< Ticks enabled with no active transfer
+} axi_dmac_sim_stats_t;
+
+/*******************************************************************************
+*
+* \details
+*
+* This function creates a model at Cfg->Base.  It must be created before the
+* driver is initialized since axi_dmac_init probes X_LENGTH and Y_LENGTH.
+*
+* \param[in]  Cfg is the model configuration
+*
+* \return     Status
+*
+*******************************************************************************/
+int32_t AxiDmacSim_Create( const axi_dmac_sim_cfg_t *Cfg );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function removes all models and resets the simulated clock.
+*
+*******************************************************************************/
+void AxiDmacSim_Reset( void );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function reads a model register.  It is called by axi_io_read.
+*
+* \param[in]  Base is the register base address
+*
+* \param[in]  Offset is the register offset
+*
+* \param[out] Data is the register value
+*
+* \return     Status, FAILURE if no model exists at Base
+*
+*******************************************************************************/
+int32_t AxiDmacSim_Read( uint32_t Base, uint32_t Offset, uint32_t *Data );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function writes a model register.  It is called by axi_io_write.
+*
+* \param[in]  Base is the register base address
+*
+* \param[in]  Offset is the register offset
+*
+* \param[in]  Data is the register value
+*
+* \return     Status, FAILURE if no model exists at Base
+*
+*******************************************************************************/
+int32_t AxiDmacSim_Write( uint32_t Base, uint32_t Offset, uint32_t Data );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function advances the simulated clock, moving data and raising
+* interrupts as transfers start and end.
+*
+* \param[in]  Ticks is the number of TIMESTAMP_FREQ_HZ ticks
+*
+*******************************************************************************/
+void AxiDmacSim_Advance( uint64_t Ticks );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function returns the simulated clock.
+*
+* \return     Time in TIMESTAMP_FREQ_HZ ticks
+*
+*******************************************************************************/
+uint64_t AxiDmacSim_GetTime( void );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function sets the time charged for every register access to model the
+* cost of the driver.  The default is zero.
+*
+* \param[in]  Ticks is the number of TIMESTAMP_FREQ_HZ ticks per access
+*
+*******************************************************************************/
+void AxiDmacSim_SetAccessCost( uint32_t Ticks );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function returns the statistics of a model.
+*
+* \param[in]  Base is the register base address
+*
+* \param[out] Stats is the returned statistics
+*
+* \return     Status
+*
+*******************************************************************************/
+int32_t AxiDmacSim_GetStats( uint32_t Base, axi_dmac_sim_stats_t *Stats );
+
+#endif /* AXI_DMAC_SIM_H_ */
@@ -0,0 +1,359 @@
+/***************************************************************************//**
+*  \addtogroup AXI_DMAC_SIM
+*   @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       axi_dmac_sim_test.c
+*
+*  \details    This file contains the host regression test of csl/axi_dmac.c
+*              run against the AXI DMAC model.  It checks big transfer
+*              splitting, cyclic repetition, hardware queue depth and the
+*              polled wait before the scheduler starts, and reports the
+*              register accesses the driver makes per transfer and checks a
+*              deeper queue loses less time to interrupt latency.  Build and
+*              run it with "make test" in this directory.  The exit status is
+*              the number of failed checks.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "axi_dmac.h"
+#include "axi_dmac_sim.h"
+#include "sim_port.h"
+#include "timestamp.h"
+#include "xscugic.h"
+
+#define SIM_BASE                (0x80000000)
+#define SIM_IRQ_ID              (100)
+#define SIM_BYTE_RATE           (4 * 61440000u)
+#define SIM_BUF_ADDR            (0x01000000)
+#define SIM_CPSR_IRQ_MASK       (0x80)
+
+#define CHECK(x)                AxiDmacSimTest_Check( (x), #x, __LINE__ )
+
+static XScuGic AxiDmacSimTestGic;
+static uint32_t AxiDmacSimTestFailCnt;
+static uint32_t AxiDmacSimTestDescCnt;
+static uint32_t AxiDmacSimTestEotCnt;
+static uint32_t AxiDmacSimTestRefillCnt;
+static axi_dmac_t *AxiDmacSimTestDmac;
+
+static void AxiDmacSimTest_Check( bool Pass, const char *Expr, int Line )
+{
+  if( !Pass )
+  {
+    printf("  FAIL line %d: %s\r\n", Line, Expr);
+    AxiDmacSimTestFailCnt++;
+  }
+}
+
+static void AxiDmacSimTest_Callback( axi_dmac_evt_type_t EvtType, void *CallbackRef )
+{
+  if( EvtType == EvtType_EndofTransfer )
+    AxiDmacSimTestEotCnt++;
+}
+
+/* Count completions and resubmit the block while refills remain */
+static void AxiDmacSimTest_DescDone( axi_dmac_desc_t *Desc, void *Param )
+{
+  AxiDmacSimTestDescCnt++;
+
+  if( AxiDmacSimTestRefillCnt > 0 )
+  {
+    AxiDmacSimTestRefillCnt--;
+    CHECK( axi_dmac_desc_submit( AxiDmacSimTestDmac, Desc->address, Desc->size, AxiDmacSimTest_DescDone, NULL ) == 0 );
+  }
+}
+
+/* Reset the model and processor and create a driver instance */
+static axi_dmac_t *AxiDmacSimTest_Setup( uint32_t XLengthBits, uint32_t YLengthBits, uint32_t QueueDepth, uint32_t Flags )
+{
+  axi_dmac_t *Dmac;
+  axi_dmac_sim_cfg_t Cfg = {
+      .Base         = SIM_BASE,
+      .IrqId        = SIM_IRQ_ID,
+      .Direction    = DMA_DEV_TO_MEM,
+      .XLengthBits  = XLengthBits,
+      .YLengthBits  = YLengthBits,
+      .QueueDepth   = QueueDepth,
+      .ByteRate     = SIM_BYTE_RATE
+  };
+  axi_dmac_init_t Init = {
+      .Callback     = AxiDmacSimTest_Callback,
+      .base         = SIM_BASE,
+      .irqId        = SIM_IRQ_ID,
+      .irqInstance  = &AxiDmacSimTestGic,
+      .direction    = DMA_DEV_TO_MEM,
+      .flags        = Flags
+  };
+
+  AxiDmacSim_Reset();
+  SimPort_Reset();
+  SimPort_SetCpsr( 0 );
+  AxiDmacSim_SetAccessCost( 0 );
+
+  if( AxiDmacSim_Create( &Cfg ) != 0 )
+    return NULL;
+
+  Timestamp_Initialize();
+
+  if( axi_dmac_init( &Dmac, &Init ) != 0 )
+    return NULL;
+
+  AxiDmacSimTestDescCnt = 0;
+  AxiDmacSimTestEotCnt = 0;
+  AxiDmacSimTestRefillCnt = 0;
+  AxiDmacSimTestDmac = Dmac;
+
+  return Dmac;
+}
+
+/* A blocking transfer longer than X_LENGTH allows is split into segments,
+   or into rows of one 2D transfer when the core supports it */
+static void AxiDmacSimTest_Split( uint32_t YLengthBits )
+{
+  axi_dmac_sim_stats_t Stats;
+  axi_dmac_t *Dmac;
+  uint32_t Size = 0x40000;
+
+  printf("Big transfer split, %s\r\n", (YLengthBits > 0) ? "2D core" : "1D core");
+
+  CHECK( (Dmac = AxiDmacSimTest_Setup( 16, YLengthBits, 4, 0 )) != NULL );
+  if( Dmac == NULL )
+    return;
+
+  CHECK( axi_dmac_transfer( Dmac, SIM_BUF_ADDR, Size ) == 0 );
+  CHECK( AxiDmacSim_GetStats( SIM_BASE, &Stats ) == 0 );
+
+  printf("  %lu bytes in %lu transfers\r\n", (unsigned long)Stats.ByteCnt, (unsigned long)Stats.CompleteCnt);
+
+  CHECK( Stats.ByteCnt == Size );
+  CHECK( Stats.SubmitCnt == ((YLengthBits > 0) ? 1 : (Size >> 16)) );
+  CHECK( Stats.CompleteCnt == Stats.SubmitCnt );
+  CHECK( Stats.StarveCnt <= 1 );
+
+  axi_dmac_remove( Dmac );
+}
+
+/* A cyclic transfer repeats until stopped, one end of transfer per pass */
+static void AxiDmacSimTest_Cyclic( void )
+{
+  axi_dmac_sim_stats_t Stats;
+  axi_dmac_t *Dmac;
+  uint32_t Size = 0x1000;
+  uint32_t Expect = (uint32_t)((uint64_t)SIM_BYTE_RATE / 1000 / Size);
+
+  printf("Cyclic repetition\r\n");
+
+  CHECK( (Dmac = AxiDmacSimTest_Setup( 16, 8, 4, DMA_CYCLIC )) != NULL );
+  if( Dmac == NULL )
+    return;
+
+  CHECK( axi_dmac_transfer_nonblocking( Dmac, SIM_BUF_ADDR, Size ) == 0 );
+  AxiDmacSim_Advance( TIMESTAMP_FREQ_HZ / 1000 );
+  CHECK( AxiDmacSim_GetStats( SIM_BASE, &Stats ) == 0 );
+
+  printf("  %lu repetitions, %lu end of transfer events in 1 ms\r\n", (unsigned long)Stats.CyclicCnt, (unsigned long)AxiDmacSimTestEotCnt);
+
+  CHECK( Stats.SubmitCnt == 1 );
+  CHECK( (Stats.CyclicCnt + 1 >= Expect) && (Stats.CyclicCnt <= Expect + 1) );
+  CHECK( AxiDmacSimTestEotCnt == Stats.CyclicCnt );
+  CHECK( Stats.StarveCnt == 0 );
+
+  /* Stop, the core must go idle */
+  CHECK( axi_dmac_transfer_nonblocking( Dmac, 0, 0 ) == 0 );
+  AxiDmacSim_Advance( TIMESTAMP_FREQ_HZ / 1000 );
+  CHECK( AxiDmacSim_GetStats( SIM_BASE, &Stats ) == 0 );
+  CHECK( Stats.CyclicCnt + 1 <= Expect + 1 );
+
+  axi_dmac_remove( Dmac );
+}
+
+/* Queued descriptors are handed to the core up to its queue depth and keep
+   it busy until the ring drains */
+static void AxiDmacSimTest_Queue( uint32_t QueueDepth )
+{
+  axi_dmac_sim_stats_t Stats;
+  axi_dmac_t *Dmac;
+  uint32_t DescCnt = 2 * AXI_DMAC_HW_QUEUE_DEPTH + 4;
+  uint32_t Cpsr;
+  uint32_t Held;
+
+  printf("Queue depth %lu\r\n", (unsigned long)QueueDepth);
+
+  CHECK( (Dmac = AxiDmacSimTest_Setup( 24, 0, QueueDepth, 0 )) != NULL );
+  if( Dmac == NULL )
+    return;
+
+  /* Submit with interrupts masked so nothing completes yet */
+  Cpsr = SimPort_GetCpsr();
+  SimPort_SetCpsr( Cpsr | SIM_CPSR_IRQ_MASK );
+
+  for( uint32_t i = 0; i < DescCnt; i++ )
+    CHECK( axi_dmac_desc_submit( Dmac, SIM_BUF_ADDR + i * 0x1000, 0x1000, AxiDmacSimTest_DescDone, NULL ) == 0 );
+
+  CHECK( AxiDmacSim_GetStats( SIM_BASE, &Stats ) == 0 );
+  Held = Stats.SubmitCnt;
+
+  SimPort_SetCpsr( Cpsr );
+  AxiDmacSim_Advance( TIMESTAMP_FREQ_HZ / 100 );
+  CHECK( AxiDmacSim_GetStats( SIM_BASE, &Stats ) == 0 );
+
+  printf("  %lu accepted before the first completion, %lu of %lu descriptors done, starved %lu times\r\n",
+      (unsigned long)Held, (unsigned long)AxiDmacSimTestDescCnt, (unsigned long)DescCnt, (unsigned long)Stats.StarveCnt);
+
+  CHECK( Held >= 1 );
+  CHECK( Held <= QueueDepth );
+  CHECK( Held <= AXI_DMAC_HW_QUEUE_DEPTH );
+  CHECK( AxiDmacSimTestDescCnt == DescCnt );
+  CHECK( Stats.CompleteCnt == Stats.SubmitCnt );
+  CHECK( Stats.ByteCnt == (uint64_t)DescCnt * 0x1000 );
+
+  /* With room for a second transfer the core only runs dry at the end */
+  if( QueueDepth > 1 )
+    CHECK( Stats.StarveCnt <= 1 );
+
+  axi_dmac_remove( Dmac );
+}
+
+/* Before the scheduler starts interrupts are masked and a blocking transfer
+   polls the core */
+static void AxiDmacSimTest_PreScheduler( void )
+{
+  axi_dmac_t *Dmac;
+
+  printf("Blocking transfer before the scheduler starts\r\n");
+
+  CHECK( (Dmac = AxiDmacSimTest_Setup( 16, 8, 4, 0 )) != NULL );
+  if( Dmac == NULL )
+    return;
+
+  SimPort_SetSchedulerRunning( false );
+  SimPort_SetCpsr( SIM_CPSR_IRQ_MASK );
+
+  CHECK( axi_dmac_transfer( Dmac, SIM_BUF_ADDR, 0x20000 ) == 0 );
+
+  SimPort_SetCpsr( 0 );
+  SimPort_SetSchedulerRunning( true );
+
+  axi_dmac_remove( Dmac );
+}
+
+/* Register accesses per transfer and the time lost between transfers when
+   each register access costs AccessCost ticks and interrupts are held off
+   for three transfer times after every eighth completion.  The access cost
+   must stay well below the transfer time so the driver is not CPU bound and
+   the loss comes from the queue running dry. */
+static int64_t AxiDmacSimTest_Overhead( uint32_t QueueDepth, uint32_t AccessCost )
+{
+  axi_dmac_sim_stats_t Stats;
+  axi_dmac_t *Dmac;
+  uint32_t DescCnt = 64;
+  uint64_t Transfer = ((uint64_t)0x1000 * TIMESTAMP_FREQ_HZ) / SIM_BYTE_RATE;
+  uint64_t Ideal = DescCnt * Transfer;
+  uint32_t NextMask = 8;
+  uint64_t Start, Elapsed;
+  int64_t Lost;
+
+  CHECK( (Dmac = AxiDmacSimTest_Setup( 24, 0, QueueDepth, 0 )) != NULL );
+  if( Dmac == NULL )
+    return 0;
+
+  AxiDmacSim_SetAccessCost( AccessCost );
+
+  /* Keep the ring full from the completion callback */
+  AxiDmacSimTestRefillCnt = DescCnt - 8;
+  Start = AxiDmacSim_GetTime();
+
+  for( uint32_t i = 0; i < 8; i++ )
+    CHECK( axi_dmac_desc_submit( Dmac, SIM_BUF_ADDR + i * 0x1000, 0x1000, AxiDmacSimTest_DescDone, NULL ) == 0 );
+
+  while( (AxiDmacSimTestDescCnt < DescCnt) && ((AxiDmacSim_GetTime() - Start) < TIMESTAMP_FREQ_HZ / 100) )
+  {
+    /* Another context runs with interrupts disabled */
+    if( AxiDmacSimTestDescCnt >= NextMask )
+    {
+      NextMask += 8;
+      SimPort_SetCpsr( SIM_CPSR_IRQ_MASK );
+      AxiDmacSim_Advance( 3 * Transfer );
+      SimPort_SetCpsr( 0 );
+    }
+
+    AxiDmacSim_Advance( 1 );
+  }
+
+  Elapsed = AxiDmacSim_GetTime() - Start;
+  Lost = ((int64_t)Elapsed - (int64_t)Ideal) / DescCnt;
+
+  CHECK( AxiDmacSim_GetStats( SIM_BASE, &Stats ) == 0 );
+  CHECK( AxiDmacSimTestDescCnt == DescCnt );
+  CHECK( Stats.CompleteCnt == DescCnt );
+
+  printf("  queue depth %lu, access cost %lu ticks: %lu reads, %lu writes, %lu interrupts, %ld ticks lost per transfer\r\n",
+      (unsigned long)QueueDepth, (unsigned long)AccessCost,
+      (unsigned long)(Stats.RegReadCnt / DescCnt), (unsigned long)(Stats.RegWriteCnt / DescCnt),
+      (unsigned long)(Stats.IrqCnt / DescCnt), (long)Lost);
+
+  axi_dmac_remove( Dmac );
+
+  return Lost;
+}
+
+int main( void )
+{
+  int64_t Lost;
+
+  setvbuf( stdout, NULL, _IONBF, 0 );
+
+  AxiDmacSimTest_Split( 0 );
+  AxiDmacSimTest_Split( 8 );
+  AxiDmacSimTest_Cyclic();
+  AxiDmacSimTest_Queue( 1 );
+  AxiDmacSimTest_Queue( 2 );
+  AxiDmacSimTest_Queue( AXI_DMAC_SIM_QUEUE_MAX );
+  AxiDmacSimTest_PreScheduler();
+
+  printf("Driver overhead\r\n");
+  AxiDmacSimTest_Overhead( 1, 0 );
+
+  Lost = AxiDmacSimTest_Overhead( 1, 50 );
+
+  /* A deeper queue rides out the interrupt latency */
+  CHECK( AxiDmacSimTest_Overhead( AXI_DMAC_SIM_QUEUE_MAX, 50 ) < Lost );
+
+  printf("%s, %lu failed checks\r\n", (AxiDmacSimTestFailCnt == 0) ? "PASS" : "FAIL", (unsigned long)AxiDmacSimTestFailCnt);
+
+  return (int)AxiDmacSimTestFailCnt;
+}
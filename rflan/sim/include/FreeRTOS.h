@@ -0,0 +1,24 @@
+#ifndef SIM_FREERTOS_H_
+#define SIM_FREERTOS_H_
+/***************************************************************************//**
+*  \file       FreeRTOS.h
+*
+*  \details    Host replacement of the FreeRTOS types used by the driver.
+*
+*******************************************************************************/
+#include <stdint.h>
+
+typedef long          BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t      TickType_t;
+
+#define configTICK_RATE_HZ          (1000)
+#define portMAX_DELAY               ((TickType_t)0xffffffffUL)
+#define pdFALSE                     ((BaseType_t)0)
+#define pdTRUE                      ((BaseType_t)1)
+#define pdPASS                      (pdTRUE)
+#define pdFAIL                      (pdFALSE)
+#define pdMS_TO_TICKS(ms)           ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define portYIELD_FROM_ISR(x)       ((void)(x))
+
+#endif /* SIM_FREERTOS_H_ */
@@ -0,0 +1,19 @@
+#ifndef SIM_SEMPHR_H_
+#define SIM_SEMPHR_H_
+/***************************************************************************//**
+*  \file       semphr.h
+*
+*  \details    Host replacement of the FreeRTOS binary semaphore, see sim_port.c.
+*
+*******************************************************************************/
+#include "FreeRTOS.h"
+
+typedef void *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateBinary( void );
+void              vSemaphoreDelete( SemaphoreHandle_t Sem );
+BaseType_t        xSemaphoreGive( SemaphoreHandle_t Sem );
+BaseType_t        xSemaphoreGiveFromISR( SemaphoreHandle_t Sem, BaseType_t *HigherPriorityTaskWoken );
+BaseType_t        xSemaphoreTake( SemaphoreHandle_t Sem, TickType_t Ticks );
+
+#endif /* SIM_SEMPHR_H_ */
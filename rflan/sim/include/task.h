@@ -0,0 +1,19 @@
+#ifndef SIM_TASK_H_
+#define SIM_TASK_H_
+/***************************************************************************//**
+*  \file       task.h
+*
+*  \details    Host replacement of the FreeRTOS task services, see sim_port.c.
+*
+*******************************************************************************/
+#include "FreeRTOS.h"
+
+#define taskSCHEDULER_SUSPENDED     ((BaseType_t)0)
+#define taskSCHEDULER_NOT_STARTED   ((BaseType_t)1)
+#define taskSCHEDULER_RUNNING       ((BaseType_t)2)
+
+BaseType_t xTaskGetSchedulerState( void );
+void       vTaskSuspendAll( void );
+BaseType_t xTaskResumeAll( void );
+
+#endif /* SIM_TASK_H_ */
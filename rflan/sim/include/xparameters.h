@@ -0,0 +1,11 @@
+#ifndef SIM_XPARAMETERS_H_
+#define SIM_XPARAMETERS_H_
+/***************************************************************************//**
+*  \file       xparameters.h
+*
+*  \details    Host replacement of the BSP parameters used by the driver.
+*
+*******************************************************************************/
+#define XPAR_CPU_CORTEXR5_0_CPU_CLK_FREQ_HZ   (500000000)
+
+#endif /* SIM_XPARAMETERS_H_ */
@@ -0,0 +1,18 @@
+#ifndef SIM_XPSEUDO_ASM_H_
+#define SIM_XPSEUDO_ASM_H_
+/***************************************************************************//**
+*  \file       xpseudo_asm.h
+*
+*  \details    Host replacement of the processor register accessors, see sim_port.c.
+*
+*******************************************************************************/
+#include "sim_port.h"
+
+#define mfcpsr()          SimPort_GetCpsr()
+#define mtcpsr(v)         SimPort_SetCpsr(v)
+#define mfcp(reg)         SimPort_ReadCp15(reg)
+#define mtcp(reg, v)      SimPort_WriteCp15((reg), (v))
+#define isb()             do { } while( 0 )
+#define dsb()             do { } while( 0 )
+
+#endif /* SIM_XPSEUDO_ASM_H_ */
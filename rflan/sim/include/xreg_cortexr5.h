@@ -0,0 +1,18 @@
+#ifndef SIM_XREG_CORTEXR5_H_
+#define SIM_XREG_CORTEXR5_H_
+/***************************************************************************//**
+*  \file       xreg_cortexr5.h
+*
+*  \details    Host replacement of the Cortex-R5 register definitions.
+*
+*******************************************************************************/
+#include "sim_port.h"
+
+#define XREG_CPSR_IRQ_ENABLE            (0x80)
+#define XREG_CPSR_FIQ_ENABLE            (0x40)
+
+#define XREG_CP15_PERF_CYCLE_COUNTER    (SIM_PORT_CP15_CYCLE_COUNTER)
+#define XREG_CP15_PERF_MONITOR_CTRL     (SIM_PORT_CP15_MONITOR_CTRL)
+#define XREG_CP15_COUNT_ENABLE_SET      (SIM_PORT_CP15_COUNT_ENABLE)
+
+#endif /* SIM_XREG_CORTEXR5_H_ */
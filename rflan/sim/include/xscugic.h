@@ -0,0 +1,24 @@
+#ifndef SIM_XSCUGIC_H_
+#define SIM_XSCUGIC_H_
+/***************************************************************************//**
+*  \file       xscugic.h
+*
+*  \details    Host replacement of the interrupt controller driver, see sim_port.c.
+*
+*******************************************************************************/
+#include <stdint.h>
+#include "xstatus.h"
+
+typedef void (*XInterruptHandler)( void *CallBackRef );
+
+typedef struct
+{
+  uint32_t              IsReady;        ///< Unused on the host
+} XScuGic;
+
+int  XScuGic_Connect( XScuGic *InstancePtr, uint32_t IntId, XInterruptHandler Handler, void *CallBackRef );
+void XScuGic_Disconnect( XScuGic *InstancePtr, uint32_t IntId );
+void XScuGic_Enable( XScuGic *InstancePtr, uint32_t IntId );
+void XScuGic_Disable( XScuGic *InstancePtr, uint32_t IntId );
+
+#endif /* SIM_XSCUGIC_H_ */
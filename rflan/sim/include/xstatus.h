@@ -0,0 +1,12 @@
+#ifndef SIM_XSTATUS_H_
+#define SIM_XSTATUS_H_
+/***************************************************************************//**
+*  \file       xstatus.h
+*
+*  \details    Host replacement of the BSP status codes.
+*
+*******************************************************************************/
+#define XST_SUCCESS     (0L)
+#define XST_FAILURE     (1L)
+
+#endif /* SIM_XSTATUS_H_ */
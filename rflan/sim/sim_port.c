@@ -0,0 +1,290 @@
+/***************************************************************************//**
+*  \addtogroup SIM_PORT
+*   @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       sim_port.c
+*
+*  \details    This file contains the host replacements for the processor,
+*              interrupt controller and FreeRTOS services.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_port.h"
+#include "axi_dmac_sim.h"
+#include "timestamp.h"
+#include "xscugic.h"
+#include "xreg_cortexr5.h"
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+
+#define SIM_PORT_DISPATCH_MAX     (1000)    ///< Handler calls per dispatch before a stuck line is reported
+#define SIM_PORT_CYCLE_READ_COST  (100)     ///< Clock advance per cycle counter read so polling loops make progress
+#define SIM_PORT_WAIT_STEP        (TIMESTAMP_FREQ_HZ / 100000)  ///< Clock step while a task is blocked
+
+/**
+**  Simulation Interrupt Line
+*/
+typedef struct
+{
+  XInterruptHandler     Handler;        ///< Connected handler
+  void                 *Ref;            ///< Handler reference
+  bool                  Enabled;        ///< Line enabled
+  bool                  Level;          ///< Line level
+  uint32_t              Cnt;            ///< Handler invocations
+} sim_port_irq_t;
+
+/**
+**  Simulation Semaphore
+*/
+typedef struct
+{
+  bool                  Given;          ///< Semaphore available
+} sim_port_sem_t;
+
+static sim_port_irq_t   SimPortIrq[SIM_PORT_MAX_IRQ];
+static uint32_t         SimPortCpsr = XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE;
+static bool             SimPortInIsr;
+static bool             SimPortSchedulerStopped;
+static uint32_t         SimPortCycleOffset;
+static uint32_t         SimPortCp15[3];
+
+/* Run handlers of pending lines until all are low or masked */
+static void SimPort_Dispatch( void )
+{
+  if( SimPortInIsr || (SimPortCpsr & XREG_CPSR_IRQ_ENABLE) )
+    return;
+
+  SimPortInIsr = true;
+
+  for( uint32_t n = 0; n < SIM_PORT_DISPATCH_MAX; n++ )
+  {
+    bool Pending = false;
+
+    for( uint32_t i = 0; i < SIM_PORT_MAX_IRQ; i++ )
+    {
+      sim_port_irq_t *Irq = &SimPortIrq[i];
+
+      if( Irq->Level && Irq->Enabled && (Irq->Handler != NULL) )
+      {
+        Irq->Cnt++;
+        Irq->Handler( Irq->Ref );
+        Pending = true;
+      }
+    }
+
+    if( !Pending )
+    {
+      SimPortInIsr = false;
+      return;
+    }
+  }
+
+  /* A handler that never clears its source would hang the target too */
+  abort( );
+}
+
+void SimPort_SetIrqLevel( uint32_t IrqId, bool Level )
+{
+  if( IrqId >= SIM_PORT_MAX_IRQ )
+    return;
+
+  SimPortIrq[IrqId].Level = Level;
+
+  if( Level )
+    SimPort_Dispatch( );
+}
+
+uint32_t SimPort_GetIrqCnt( uint32_t IrqId )
+{
+  return (IrqId < SIM_PORT_MAX_IRQ) ? SimPortIrq[IrqId].Cnt : 0;
+}
+
+uint32_t SimPort_GetCpsr( void )
+{
+  return SimPortCpsr;
+}
+
+void SimPort_SetCpsr( uint32_t Cpsr )
+{
+  SimPortCpsr = Cpsr;
+  SimPort_Dispatch( );
+}
+
+uint32_t SimPort_ReadCp15( uint32_t Reg )
+{
+  if( Reg == SIM_PORT_CP15_CYCLE_COUNTER )
+  {
+    AxiDmacSim_Advance( SIM_PORT_CYCLE_READ_COST );
+    return (uint32_t)AxiDmacSim_GetTime( ) - SimPortCycleOffset;
+  }
+
+  return (Reg < 3) ? SimPortCp15[Reg] : 0;
+}
+
+void SimPort_WriteCp15( uint32_t Reg, uint32_t Data )
+{
+  if( Reg >= 3 )
+    return;
+
+  /* Cycle counter reset bit of PMCR */
+  if( (Reg == SIM_PORT_CP15_MONITOR_CTRL) && (Data & 0x4) )
+  {
+    SimPortCycleOffset = (uint32_t)AxiDmacSim_GetTime( );
+    Data &= ~0x4;
+  }
+
+  SimPortCp15[Reg] = Data;
+}
+
+void SimPort_SetSchedulerRunning( bool Running )
+{
+  SimPortSchedulerStopped = !Running;
+}
+
+void SimPort_Reset( void )
+{
+  memset( SimPortIrq, 0, sizeof(SimPortIrq) );
+  memset( SimPortCp15, 0, sizeof(SimPortCp15) );
+  SimPortCpsr = XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE;
+  SimPortInIsr = false;
+  SimPortSchedulerStopped = false;
+  SimPortCycleOffset = 0;
+}
+
+/* Interrupt controller */
+int XScuGic_Connect( XScuGic *InstancePtr, uint32_t IntId, XInterruptHandler Handler, void *CallBackRef )
+{
+  if( IntId >= SIM_PORT_MAX_IRQ )
+    return XST_FAILURE;
+
+  SimPortIrq[IntId].Handler = Handler;
+  SimPortIrq[IntId].Ref = CallBackRef;
+
+  return XST_SUCCESS;
+}
+
+void XScuGic_Disconnect( XScuGic *InstancePtr, uint32_t IntId )
+{
+  if( IntId < SIM_PORT_MAX_IRQ )
+  {
+    SimPortIrq[IntId].Handler = NULL;
+    SimPortIrq[IntId].Ref = NULL;
+  }
+}
+
+void XScuGic_Enable( XScuGic *InstancePtr, uint32_t IntId )
+{
+  if( IntId < SIM_PORT_MAX_IRQ )
+  {
+    SimPortIrq[IntId].Enabled = true;
+    SimPort_Dispatch( );
+  }
+}
+
+void XScuGic_Disable( XScuGic *InstancePtr, uint32_t IntId )
+{
+  if( IntId < SIM_PORT_MAX_IRQ )
+    SimPortIrq[IntId].Enabled = false;
+}
+
+/* FreeRTOS */
+SemaphoreHandle_t xSemaphoreCreateBinary( void )
+{
+  return (SemaphoreHandle_t)calloc( 1, sizeof(sim_port_sem_t) );
+}
+
+void vSemaphoreDelete( SemaphoreHandle_t Sem )
+{
+  free( Sem );
+}
+
+BaseType_t xSemaphoreGive( SemaphoreHandle_t Sem )
+{
+  sim_port_sem_t *s = (sim_port_sem_t *)Sem;
+
+  if( s->Given )
+    return pdFAIL;
+
+  s->Given = true;
+
+  return pdPASS;
+}
+
+BaseType_t xSemaphoreGiveFromISR( SemaphoreHandle_t Sem, BaseType_t *HigherPriorityTaskWoken )
+{
+  if( HigherPriorityTaskWoken != NULL )
+    *HigherPriorityTaskWoken = pdTRUE;
+
+  return xSemaphoreGive( Sem );
+}
+
+/* A blocked task lets the simulated clock run until it is given or times out */
+BaseType_t xSemaphoreTake( SemaphoreHandle_t Sem, TickType_t Ticks )
+{
+  sim_port_sem_t *s = (sim_port_sem_t *)Sem;
+  uint64_t Deadline = AxiDmacSim_GetTime( ) + (uint64_t)Ticks * (TIMESTAMP_FREQ_HZ / configTICK_RATE_HZ);
+
+  while( !s->Given )
+  {
+    uint64_t Now = AxiDmacSim_GetTime( );
+
+    if( Now >= Deadline )
+      return pdFAIL;
+
+    AxiDmacSim_Advance( ((Deadline - Now) < SIM_PORT_WAIT_STEP) ? (Deadline - Now) : SIM_PORT_WAIT_STEP );
+  }
+
+  s->Given = false;
+
+  return pdPASS;
+}
+
+BaseType_t xTaskGetSchedulerState( void )
+{
+  return SimPortSchedulerStopped ? taskSCHEDULER_NOT_STARTED : taskSCHEDULER_RUNNING;
+}
+
+void vTaskSuspendAll( void )
+{
+}
+
+BaseType_t xTaskResumeAll( void )
+{
+  return pdFALSE;
+}
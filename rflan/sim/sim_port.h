@@ -0,0 +1,132 @@
+#ifndef SIM_PORT_H_
+#define SIM_PORT_H_
+/***************************************************************************//**
+*  \ingroup    AXI_DMAC_SIM
+*  \defgroup   SIM_PORT Simulation Port
+*  @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       sim_port.h
+*
+*  \details
+*
+*  This file contains the host replacements for the processor, interrupt
+*  controller and FreeRTOS services used by the driver.  The shim headers in
+*  sim/include map the BSP and FreeRTOS calls onto these functions.
+*
+*  Interrupts are level triggered.  A connected handler runs when its line is
+*  high, the line is enabled and CPSR does not mask IRQs.  Handlers do not
+*  nest.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SIM_PORT_MAX_IRQ            (256)   ///< Number of interrupt IDs
+#define SIM_PORT_CP15_CYCLE_COUNTER (0)     ///< Cycle counter register ID
+#define SIM_PORT_CP15_MONITOR_CTRL  (1)     ///< Performance monitor control register ID
+#define SIM_PORT_CP15_COUNT_ENABLE  (2)     ///< Count enable set register ID
+
+/*******************************************************************************
+*
+* \details
+*
+* This function sets the level of an interrupt line and runs its handler if
+* the line is high and not masked.
+*
+* \param[in]  IrqId is the interrupt ID
+*
+* \param[in]  Level is the line level
+*
+*******************************************************************************/
+void SimPort_SetIrqLevel( uint32_t IrqId, bool Level );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function returns the number of handler invocations for an interrupt.
+*
+* \param[in]  IrqId is the interrupt ID
+*
+* \return     Handler invocations
+*
+*******************************************************************************/
+uint32_t SimPort_GetIrqCnt( uint32_t IrqId );
+
+/*******************************************************************************
+*
+* \details
+*
+* These functions replace the CPSR accessors.  Clearing the IRQ mask runs any
+* handler whose line is pending.
+*
+*******************************************************************************/
+uint32_t SimPort_GetCpsr( void );
+void     SimPort_SetCpsr( uint32_t Cpsr );
+
+/*******************************************************************************
+*
+* \details
+*
+* These functions replace the CP15 accessors.  The cycle counter returns the
+* simulated clock, and each read advances it a little so polling loops end.
+*
+*******************************************************************************/
+uint32_t SimPort_ReadCp15( uint32_t Reg );
+void     SimPort_WriteCp15( uint32_t Reg, uint32_t Data );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function sets whether xTaskGetSchedulerState reports a running
+* scheduler, which selects between the sleeping and polling wait in
+* axi_dmac_transfer_timeout.  The default is running.
+*
+* \param[in]  Running is the scheduler state
+*
+*******************************************************************************/
+void SimPort_SetSchedulerRunning( bool Running );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function resets the interrupt table and processor state.
+*
+*******************************************************************************/
+void SimPort_Reset( void );
+
+#endif /* SIM_PORT_H_ */
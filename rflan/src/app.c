@@ -54,6 +54,10 @@
 #include "zmodem.h"
 #include "xdppsu.h"
 #include "versa_clock5.h"
+#include "timestamp.h"
+#include "iq_buf.h"
+#include "mem_dma.h"
+#include "iq_file.h"
 
 static TaskHandle_t 			AppTask;
 FATFS sdfs;
@@ -63,10 +67,26 @@ static void App_Task( void *pvParameters )
 {
 	int status;
 
+  /* Initialize Timestamp */
+  if((status = Timestamp_Initialize()) != 0)
+    xil_printf("Timestamp Initialize Error %d\r\n",status);
+
+  /* Initialize IQ Buffers */
+  if((status = IqBuf_Initialize()) != 0)
+    xil_printf("IQ Buffer Initialize Error %d\r\n",status);
+
+  /* Initialize Memory DMA */
+  if((status = MemDma_Initialize()) != 0)
+    xil_printf("Memory DMA Initialize Error %d\r\n",status);
+
   /* Mount File System */
   if(f_mount(&sdfs, FF_LOGICAL_DRIVE_PATH, 1) != FR_OK)
     xil_printf("Failed to initialize file system\r\n");
 
+  /* Initialize IQ File Writer */
+  if((status = IqFile_Initialize()) != 0)
+    xil_printf("IQ File Initialize Error %d\r\n",status);
+
 	/* Initialize CLI */
 	if((status = AppCli_Initialize()) != 0)
 	  xil_printf("CLI Initialize Error %d\r\n",status);
@@ -98,6 +118,9 @@ static void App_Task( void *pvParameters )
 	for( ;; )
 	{
 		vTaskDelay(1000);
+
+		/* Track cycle counter wrap */
+		Timestamp_Get();
 	}
 }
 
@@ -58,6 +58,11 @@
 #include "ff.h"
 #include "xuartps.h"
 #include "zmodem.h"
+#include "iq_buf.h"
+#include "mem_dma.h"
+#include "mem_pool.h"
+#include "ddr_arena.h"
+#include "timestamp.h"
 
 
 static Cli_t            AppCli;
@@ -279,6 +284,144 @@ static const CliCmd_t AppCliTaskInfoDef =
   NULL
 };
 
+/*******************************************************************************
+*
+* \details Report IQ Buffer Arena Usage
+*
+*******************************************************************************/
+static void AppCli_IqBufInfo(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  iq_buf_stats_t Stats;
+
+  if( IqBuf_GetStats( &Stats ) != XST_SUCCESS )
+    return;
+
+  printf("Size         %lu\r\n", Stats.Size);
+  printf("Used         %lu\r\n", Stats.Used);
+  printf("High Water   %lu\r\n", Stats.HighWater);
+  printf("Largest Free %lu\r\n", Stats.LargestFree);
+  printf("Alloc        %lu\r\n", Stats.AllocCnt);
+  printf("Free         %lu\r\n", Stats.FreeCnt);
+  printf("Failed       %lu\r\n", Stats.FailCnt);
+}
+
+static const CliCmd_t AppCliIqBufInfoDef =
+{
+  "IqBufInfo",
+  "IqBufInfo: Get IQ buffer arena usage \r\n"
+  "IqBufInfo < >\r\n\n",
+  (CliCmdFn_t)AppCli_IqBufInfo,
+  0,
+  NULL
+};
+
+/*******************************************************************************
+*
+* \details Report DDR Arena Regions
+*
+*******************************************************************************/
+static void AppCli_DdrArenaInfo(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  ddr_arena_stats_t Stats;
+  uint32_t Size;
+  uint32_t Free;
+
+  DdrArena_GetInfo( &Size, &Free );
+
+  printf("Arena %lu bytes, %lu not in a region\r\n\r\n", Size, Free);
+  printf("Name            Base        Size      Used      High      Alloc   Failed  Reset\r\n");
+  printf("-------------------------------------------------------------------------------\r\n");
+
+  for( uint32_t i = 0; DdrArena_GetStats( i, &Stats ) == XST_SUCCESS; i++ )
+  {
+    printf("%-16s0x%08lx  %-10lu%-10lu%-10lu%-8lu%-8lu%lu\r\n", Stats.Name, (uint32_t)Stats.Base, Stats.Size,
+        Stats.Used, Stats.HighWater, Stats.AllocCnt, Stats.FailCnt, Stats.ResetCnt);
+  }
+}
+
+static const CliCmd_t AppCliDdrArenaInfoDef =
+{
+  "DdrArenaInfo",
+  "DdrArenaInfo: Get DDR arena region usage \r\n"
+  "DdrArenaInfo < >\r\n\n",
+  (CliCmdFn_t)AppCli_DdrArenaInfo,
+  0,
+  NULL
+};
+
+/*******************************************************************************
+*
+* \details Report Memory DMA Statistics
+*
+*******************************************************************************/
+static void AppCli_MemDmaInfo(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  mem_dma_stats_t Stats;
+
+  if( MemDma_GetStats( &Stats ) != XST_SUCCESS )
+    return;
+
+  printf("Copy         %lu\r\n", Stats.CopyCnt);
+  printf("Fill         %lu\r\n", Stats.FillCnt);
+  printf("Copy 2D      %lu\r\n", Stats.Copy2dCnt);
+  printf("Error        %lu\r\n", Stats.ErrorCnt);
+  printf("Queue Full   %lu\r\n", Stats.QueueFullCnt);
+  printf("Queue High   %lu\r\n", Stats.QueueHighWater);
+  printf("Bytes        %llu\r\n", Stats.ByteCnt);
+  printf("Busy         %lluus\r\n", Timestamp_ToUs( Stats.BusyTime ));
+}
+
+static const CliCmd_t AppCliMemDmaInfoDef =
+{
+  "MemDmaInfo",
+  "MemDmaInfo: Get memory DMA statistics \r\n"
+  "MemDmaInfo < >\r\n\n",
+  (CliCmdFn_t)AppCli_MemDmaInfo,
+  0,
+  NULL
+};
+
+/*******************************************************************************
+*
+* \details Report Memory Pool Usage
+*
+*******************************************************************************/
+static void AppCli_MemPoolInfo(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  mem_pool_stats_t Stats;
+  mem_pool_block_t List[APP_CLI_MEM_POOL_LIST_SIZE];
+  uint32_t Cnt;
+
+  printf("Size  Blocks  Used  High  Alloc       Free        Failed  Bad Free\r\n");
+  printf("-----------------------------------------------------------------\r\n");
+
+  for( uint32_t i = 0; i < MEM_POOL_CLASS_CNT; i++ )
+  {
+    if( MemPool_GetStats( i, &Stats ) != XST_SUCCESS )
+      return;
+
+    printf("%-6lu%-8lu%-6lu%-6lu%-12lu%-12lu%-8lu%lu\r\n", Stats.BlockSize, Stats.BlockCnt,
+        Stats.Used, Stats.HighWater, Stats.AllocCnt, Stats.FreeCnt, Stats.FailCnt, Stats.BadFreeCnt);
+  }
+
+  Cnt = MemPool_GetOutstanding( List, APP_CLI_MEM_POOL_LIST_SIZE );
+
+  printf("\r\nOutstanding %lu\r\n", Cnt);
+
+  for( uint32_t i = 0; (i < Cnt) && (i < APP_CLI_MEM_POOL_LIST_SIZE); i++ )
+    printf("  %p  %4lu bytes  allocated by %p\r\n", List[i].Buf, List[i].BlockSize, List[i].Owner);
+}
+
+static const CliCmd_t AppCliMemPoolInfoDef =
+{
+  "MemPoolInfo",
+  "MemPoolInfo: Get memory pool usage and outstanding blocks \r\n"
+  "MemPoolInfo < >\r\n\n",
+  (CliCmdFn_t)AppCli_MemPoolInfo,
+  0,
+  NULL
+};
+
 /*******************************************************************************
 *
 * \details Delete File
@@ -286,7 +429,14 @@ static const CliCmd_t AppCliTaskInfoDef =
 *******************************************************************************/
 static void AppCli_fdelete(Cli_t *CliInstance, const char *cmd, void *userData)
 {
-  char *filename = calloc(1, FF_FILENAME_MAX_LEN );
+  char *filename = MemPool_Alloc( FF_FILENAME_MAX_LEN );
+
+  if( filename == NULL )
+  {
+    printf("Insufficient Memory\r\n");
+    return;
+  }
+
   strcpy(filename,FF_LOGICAL_DRIVE_PATH);
 
   Cli_GetParameter(cmd, 1, CliParamTypeStr, &filename[strlen(filename)]);
@@ -299,6 +449,8 @@ static void AppCli_fdelete(Cli_t *CliInstance, const char *cmd, void *userData)
   {
     printf("Success\r\n");
   }
+
+  MemPool_Free(filename);
 }
 
 static const CliCmd_t AppCliDeleteFileDef =
@@ -326,7 +478,14 @@ static void AppCli_fread(Cli_t *CliInstance, const char *cmd, void *userData)
   uint32_t size;
   char c;
 
-  char *filename = calloc(1, FF_FILENAME_MAX_LEN );
+  char *filename = MemPool_Alloc( FF_FILENAME_MAX_LEN );
+
+  if( filename == NULL )
+  {
+    printf("Insufficient Memory\r\n");
+    return;
+  }
+
   strcpy(filename,FF_LOGICAL_DRIVE_PATH);
 
   Cli_GetParameter(cmd, 1, CliParamTypeStr, &filename[strlen(filename)]);
@@ -369,7 +528,7 @@ static void AppCli_fread(Cli_t *CliInstance, const char *cmd, void *userData)
     printf("Failed\r\n");
   }
 
-  free(filename);
+  MemPool_Free(filename);
   f_close(&fil);
 }
 
@@ -452,6 +611,10 @@ int AppCli_Initialize( void )
 	  Cli_RegisterCommand(&AppCli, &AppCliClsDef);
 	  Cli_RegisterCommand(&AppCli, &AppCliLsDef);
 	  Cli_RegisterCommand(&AppCli, &AppCliTaskInfoDef);
+	  Cli_RegisterCommand(&AppCli, &AppCliIqBufInfoDef);
+	  Cli_RegisterCommand(&AppCli, &AppCliDdrArenaInfoDef);
+	  Cli_RegisterCommand(&AppCli, &AppCliMemDmaInfoDef);
+	  Cli_RegisterCommand(&AppCli, &AppCliMemPoolInfoDef);
 	  Cli_RegisterCommand(&AppCli, &AppCliReadFileDef);
 	  Cli_RegisterCommand(&AppCli, &AppCliDeleteFileDef);
 
@@ -48,71 +48,326 @@
 #include "error.h"
 #include "axi_dmac.h"
 #include "util.h"
+#include "timestamp.h"
+#include "mem_pool.h"
 #include "xscugic.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexr5.h"
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+
+static axi_dmac_t *axi_dmac_instance[AXI_DMAC_MAX_INSTANCES];
 
 /***************************************************************************//**
- * @brief dma_isr
-*******************************************************************************/
-void axi_dmac_default_isr(void *instance)
+ * @brief axi_dmac_lock - mask interrupts while the descriptor ring is updated
+ *******************************************************************************/
+static inline uint32_t axi_dmac_lock(void)
 {
-	axi_dmac_t *dmac = (axi_dmac_t *)instance;
-	uint32_t remaining_size, burst_size;
-	uint32_t reg_val;
+	uint32_t cpsr = mfcpsr();
 
-	/* Get interrupt sources and clear interrupts. */
-	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
-	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
+	mtcpsr(cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+
+	return cpsr;
+}
+
+static inline void axi_dmac_unlock(uint32_t cpsr)
+{
+	mtcpsr(cpsr);
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_desc_reset - discard outstanding descriptors, the hardware
+ *        queue must have been flushed by disabling the core
+ *******************************************************************************/
+static void axi_dmac_desc_reset(axi_dmac_t *dmac)
+{
+	dmac->desc_head = 0;
+	dmac->desc_queue = 0;
+	dmac->desc_tail = 0;
+	dmac->hw_head = 0;
+	dmac->hw_count = 0;
+	dmac->sot_armed = true;
+	dmac->big_transfer.address = 0;
+	dmac->big_transfer.size = 0;
+	dmac->big_transfer.size_done = 0;
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_desc_fill - hand descriptor segments to the hardware until
+ *        its queue is full, must be called from the ISR or with interrupts masked
+ *******************************************************************************/
+static void axi_dmac_desc_fill(axi_dmac_t *dmac)
+{
+	axi_dmac_desc_t *desc;
+	axi_dmac_desc_t *next;
+	uint64_t address;
+	uint32_t burst_size;
+	uint32_t remaining;
+	uint32_t rows;
+	uint32_t last_desc;
+	uint32_t merged;
+	uint32_t i;
+	bool wait;
+	uint32_t x_length;
+	uint32_t y_length;
+	uint32_t stride;
+	uint32_t reg_val;
+	uint32_t id;
 
-	if ((reg_val & AXI_DMAC_IRQ_SOT) && (dmac->big_transfer.size != 0))
+	while ((dmac->hw_count < AXI_DMAC_HW_QUEUE_DEPTH) && (dmac->desc_queue != dmac->desc_head))
 	{
-		remaining_size = dmac->big_transfer.size - dmac->big_transfer.size_done;
+		/* The previous segment has not been accepted yet. */
+		axi_dmac_read(dmac, AXI_DMAC_REG_START_TRANSFER, &reg_val);
+		if (reg_val & 1)
+			break;
+
+		desc = &dmac->desc[dmac->desc_queue % AXI_DMAC_DESC_RING_SIZE];
+		last_desc = dmac->desc_queue;
 
-		burst_size = (remaining_size <= dmac->transfer_max_size) ? remaining_size : dmac->transfer_max_size;
+		if (desc->row_size != 0)
+		{
+			/* 2D descriptors were checked to fit a single segment. */
+			burst_size = desc->size;
+			x_length = desc->row_size - 1;
+			y_length = (desc->size / desc->row_size) - 1;
+			stride = desc->row_stride;
+		}
+		else if (desc->chunk_size < desc->size)
+		{
+			/* Next chunk of the plan made at submission. */
+			remaining = desc->size - desc->size_queued;
+			rows = remaining / desc->chunk_size;
+			if (rows > desc->chunk_rows)
+				rows = desc->chunk_rows;
+
+			if (rows > 1)
+			{
+				burst_size = rows * desc->chunk_size;
+				x_length = desc->chunk_size - 1;
+				y_length = rows - 1;
+				stride = desc->chunk_size;
+			}
+			else
+			{
+				burst_size = (remaining < desc->chunk_size) ? remaining : desc->chunk_size;
+				x_length = burst_size - 1;
+				y_length = 0;
+				stride = 0;
+			}
+		}
+		else
+		{
+			burst_size = desc->size;
+
+			/* Merge whole descriptors that follow on in memory so they
+			 * complete with a single interrupt. */
+			merged = 1;
+			wait = false;
+			while ((desc->size_queued == 0) && (merged < dmac->coalesce_cnt))
+			{
+				/* Wait for a full batch while a transfer is queued behind
+				 * the active one, the hardware cannot run dry before the
+				 * next EOT. */
+				if ((last_desc + 1) == dmac->desc_head)
+				{
+					wait = (dmac->hw_count >= 2);
+					break;
+				}
+
+				next = &dmac->desc[(last_desc + 1) % AXI_DMAC_DESC_RING_SIZE];
+				if ((next->row_size != 0) || (next->address != (desc->address + burst_size)) ||
+				    ((burst_size + next->size - 1) > dmac->transfer_max_size))
+					break;
+
+				burst_size += next->size;
+				last_desc++;
+				merged++;
+			}
+
+			if (wait)
+				break;
+
+			x_length = burst_size - 1;
+			y_length = 0;
+			stride = 0;
+		}
 
-		dmac->big_transfer.size_done += burst_size;
-		dmac->big_transfer.address += burst_size;
+		address = desc->address + desc->size_queued;
 
 		switch (dmac->direction)
 		{
 		case DMA_DEV_TO_MEM:
-			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS, dmac->big_transfer.address);
-			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_STRIDE, 0x0);
+			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS, (uint32_t)address);
+			if (dmac->addr_high_mask != 0)
+				axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS_HIGH, (uint32_t)(address >> 32));
+			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_STRIDE, stride);
 			break;
 
 		case DMA_MEM_TO_DEV:
-			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS, dmac->big_transfer.address);
-			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, 0x0);
+			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS, (uint32_t)address);
+			if (dmac->addr_high_mask != 0)
+				axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS_HIGH, (uint32_t)(address >> 32));
+			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, stride);
 			break;
 
 		default:
 			return; // Other directions are not supported yet
 		}
 
-		/* The current transfer was started and a new one is queued. */
-		axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, burst_size);
-		axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+		axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, x_length);
+		axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, y_length);
+		axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, dmac->flags);
+
+		/* Record which descriptor owns the ID this segment will be given. */
+		axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &id);
+		id %= AXI_DMAC_HW_QUEUE_DEPTH;
+
+		if (dmac->hw_count == 0)
+			dmac->hw_head = id;
+
+		if (last_desc != dmac->desc_queue)
+		{
+			/* Merged descriptors are queued whole. */
+			for (i = dmac->desc_queue; i != (last_desc + 1); i++)
+				dmac->desc[i % AXI_DMAC_DESC_RING_SIZE].size_queued =
+					dmac->desc[i % AXI_DMAC_DESC_RING_SIZE].size;
+
+			dmac->hw[id].last = true;
+		}
+		else
+		{
+			desc->size_queued += burst_size;
+			dmac->hw[id].last = (desc->size_queued == desc->size);
+		}
+
+		dmac->hw[id].desc = last_desc;
+		dmac->hw_count++;
+
+		if (dmac->hw[id].last)
+			dmac->desc_queue = last_desc + 1;
+
+		/* Without the SOT interrupt note when the core starts from idle. */
+		if ((dmac->irq_mask & AXI_DMAC_IRQ_SOT) && dmac->sot_armed)
+		{
+			dmac->sot_timestamp = Timestamp_Get();
+			dmac->sot_armed = false;
+		}
+
 		axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
 	}
+}
 
-  axi_dmac_evt_type_t evt;
+/***************************************************************************//**
+ * @brief axi_dmac_desc_complete - retire finished segments in submission order
+ *        and complete their descriptors, returns number of descriptors completed
+ *******************************************************************************/
+static uint32_t axi_dmac_desc_complete(axi_dmac_t *dmac, uint64_t timestamp)
+{
+	axi_dmac_hw_slot_t *slot;
+	axi_dmac_desc_t desc;
+	uint32_t completed = 0;
+	uint32_t pending;
+	uint32_t tail;
+	uint32_t done;
 
-	if (reg_val & AXI_DMAC_IRQ_EOT)
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_DONE, &done);
+
+	/* A segment not yet accepted still shows the done bit of the previous
+	 * transfer with its ID. */
+	axi_dmac_read(dmac, AXI_DMAC_REG_START_TRANSFER, &pending);
+	pending &= 1;
+
+	/* Submissions from callbacks are handed to the hardware by the caller
+	 * once all are in so they can be merged. */
+	dmac->completing = true;
+
+	while ((dmac->hw_count > pending) && (done & (1u << dmac->hw_head)))
 	{
-	  evt = EvtType_EndofTransfer;
-	  dmac->big_transfer.transfer_done = true;
-    dmac->big_transfer.address = 0;
-    dmac->big_transfer.size = 0;
-    dmac->big_transfer.size_done = 0;
+		slot = &dmac->hw[dmac->hw_head];
+
+		dmac->hw_head = (dmac->hw_head + 1) % AXI_DMAC_HW_QUEUE_DEPTH;
+		dmac->hw_count--;
+
+		/* A merged transfer completes several descriptors at once. */
+		while (slot->last && ((int32_t)(slot->desc - dmac->desc_tail) >= 0))
+		{
+			/* Copy so the callback may submit into the freed entry. */
+			desc = dmac->desc[dmac->desc_tail % AXI_DMAC_DESC_RING_SIZE];
+			desc.timestamp = timestamp;
+			tail = ++dmac->desc_tail;
+			completed++;
+
+			if (desc.callback != NULL)
+				desc.callback(&desc, desc.param);
+
+			/* The callback stopped the core and reset the ring. */
+			if (dmac->desc_tail != tail)
+			{
+				dmac->completing = false;
+				return completed;
+			}
+		}
 	}
-	else if(reg_val & AXI_DMAC_IRQ_SOT)
+
+	dmac->completing = false;
+
+	if (dmac->desc_tail == dmac->desc_head)
 	{
-    evt = EvtType_StartofTransfer;
+		dmac->big_transfer.transfer_done = true;
+		dmac->sot_armed = true;
 	}
 
-  if( dmac->Callback != NULL )
-  {
-    dmac->Callback(evt, dmac->CallbackRef );
-  }
+	return completed;
+}
+
+/***************************************************************************//**
+ * @brief dma_isr
+*******************************************************************************/
+void axi_dmac_default_isr(void *instance)
+{
+	axi_dmac_t *dmac = (axi_dmac_t *)instance;
+	uint32_t completed = 0;
+	uint32_t reg_val;
+	uint64_t timestamp = Timestamp_Get();
+
+	/* Get interrupt sources and clear interrupts. */
+	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
+
+	/* Capture start of a transfer from idle and end of transfer. */
+	if ((reg_val & AXI_DMAC_IRQ_SOT) && dmac->sot_armed)
+	{
+		dmac->sot_timestamp = timestamp;
+		dmac->sot_armed = false;
+	}
+
+	if (reg_val & AXI_DMAC_IRQ_EOT)
+	{
+		dmac->eot_timestamp = timestamp;
+		completed = axi_dmac_desc_complete(dmac, timestamp);
+
+		/* Cyclic transfers never complete. */
+		if ((completed == 0) && (dmac->flags & DMA_CYCLIC))
+			completed = 1;
+	}
+
+	/* Keep the hardware queue full. */
+	axi_dmac_desc_fill(dmac);
+
+	if( dmac->Callback != NULL )
+	{
+		if (completed > 0)
+		{
+			/* One event per completed descriptor even when interrupts coalesce. */
+			while (completed--)
+				dmac->Callback(EvtType_EndofTransfer, dmac->CallbackRef );
+		}
+		else if (reg_val & AXI_DMAC_IRQ_SOT)
+		{
+			dmac->Callback(EvtType_StartofTransfer, dmac->CallbackRef );
+		}
+	}
 }
 
 /***************************************************************************//**
@@ -136,182 +391,368 @@ int32_t axi_dmac_write(axi_dmac_t *dmac, uint32_t reg_addr, uint32_t reg_data)
 }
 
 /***************************************************************************//**
- * @brief axi_dmac_transfer_nonblock
+ * @brief axi_dmac_desc_plan - split a large 1D descriptor into chunks up
+ *        front. With 2D support whole rows of the largest chunk run as one
+ *        hardware transfer and the remainder follows, otherwise the chunks
+ *        are of equal size so none is short enough to finish before the
+ *        ISR can queue the next.
  *******************************************************************************/
-int32_t axi_dmac_transfer_nonblocking(axi_dmac_t *dmac, uint32_t address, uint32_t size)
+static void axi_dmac_desc_plan(axi_dmac_t *dmac, axi_dmac_desc_t *desc)
+{
+	uint64_t max_size = (uint64_t)dmac->transfer_max_size + 1;
+	uint32_t chunk_max = (uint32_t)(max_size & ~(uint64_t)(AXI_DMAC_CHUNK_ALIGN - 1));
+	uint32_t chunk_cnt;
+
+	desc->chunk_size = desc->size;
+	desc->chunk_rows = 1;
+
+	if (desc->size <= max_size)
+		return;
+
+	if (dmac->y_max != 0)
+	{
+		desc->chunk_size = chunk_max;
+		desc->chunk_rows = desc->size / chunk_max;
+		if ((desc->chunk_rows - 1) > dmac->y_max)
+			desc->chunk_rows = dmac->y_max + 1;
+	}
+	else
+	{
+		chunk_cnt = (desc->size + chunk_max - 1) / chunk_max;
+		desc->chunk_size = (desc->size + chunk_cnt - 1) / chunk_cnt;
+		desc->chunk_size = (desc->chunk_size + AXI_DMAC_CHUNK_ALIGN - 1) & ~(AXI_DMAC_CHUNK_ALIGN - 1);
+	}
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_desc_queue
+ *******************************************************************************/
+static int32_t axi_dmac_desc_queue(axi_dmac_t *dmac, uint64_t address, uint32_t size,
+				   uint32_t row_size, uint32_t row_stride,
+				   axi_dmac_desc_callback_t callback, void *param)
 {
+	axi_dmac_desc_t *desc;
 	uint32_t reg_val;
+	uint32_t cpsr;
 
-  if (size == 0)
-  {
-    axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
-    return SUCCESS;
-  }
+	if ((size == 0) ||
+	    ((dmac->direction != DMA_DEV_TO_MEM) && (dmac->direction != DMA_MEM_TO_DEV)))
+		return FAILURE; // Other directions are not supported yet
+
+	/* A 2D transfer must fit in a single segment. */
+	if ((row_size != 0) &&
+	    ((dmac->y_max == 0) || (row_stride < row_size) || (size % row_size) ||
+	     ((row_size - 1) > dmac->transfer_max_size) || ((size / row_size - 1) > dmac->y_max)))
+		return FAILURE;
+
+	/* Addresses above 4 GiB need a core with a wider address bus. */
+	if (((address + size - 1) >> 32) & ~(uint64_t)dmac->addr_high_mask)
+		return FAILURE;
+
+	cpsr = axi_dmac_lock();
+
+	if ((dmac->desc_head - dmac->desc_tail) >= AXI_DMAC_DESC_RING_SIZE)
+	{
+		axi_dmac_unlock(cpsr);
+		return FAILURE;
+	}
 
 	axi_dmac_read(dmac, AXI_DMAC_REG_CTRL, &reg_val);
 	if (!(reg_val & AXI_DMAC_CTRL_ENABLE))
 	{
 		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
 		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
-		axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
+		axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, dmac->irq_mask);
+		axi_dmac_desc_reset(dmac);
 	}
 
-	axi_dmac_read(dmac, AXI_DMAC_REG_START_TRANSFER, &reg_val);
-	if (!(reg_val & 1))
+	desc = &dmac->desc[dmac->desc_head % AXI_DMAC_DESC_RING_SIZE];
+	desc->address = address;
+	desc->size = size;
+	desc->size_queued = 0;
+	desc->row_size = row_size;
+	desc->row_stride = row_stride;
+	desc->callback = callback;
+	desc->param = param;
+	desc->timestamp = 0;
+
+	if (row_size == 0)
+		axi_dmac_desc_plan(dmac, desc);
+	else
 	{
-		switch (dmac->direction)
-		{
-		case DMA_DEV_TO_MEM:
-			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS, address);
-			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_STRIDE, 0x0);
-			break;
+		desc->chunk_size = size;
+		desc->chunk_rows = 1;
+	}
 
-		case DMA_MEM_TO_DEV:
-			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS, address);
-			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, 0x0);
-			break;
+	dmac->desc_head++;
+	dmac->big_transfer.transfer_done = false;
 
-		default:
-			return FAILURE; // Other directions are not supported yet
-		}
+	if (!dmac->completing)
+		axi_dmac_desc_fill(dmac);
 
-		if ((size - 1) > dmac->transfer_max_size)
-		{
-			dmac->big_transfer.address = address;
-			dmac->big_transfer.size = size - 1;
-			dmac->big_transfer.size_done = dmac->transfer_max_size;
-
-			axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, dmac->transfer_max_size);
-			axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
-			axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, dmac->flags);
-			axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
-		}
-		else
-		{
-			axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, size - 1);
-			axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
-			axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, dmac->flags);
-			axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
-		}
-	}
-	else
-	{
+	axi_dmac_unlock(cpsr);
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_desc_submit - queue a transfer behind those already
+ *        outstanding, callback is invoked from the ISR when it completes.
+ *        The row layout set by axi_dmac_set_stride is applied.
+ *******************************************************************************/
+int32_t axi_dmac_desc_submit(axi_dmac_t *dmac, uint64_t address, uint32_t size,
+			     axi_dmac_desc_callback_t callback, void *param)
+{
+	return axi_dmac_desc_queue(dmac, address, size, dmac->row_size, dmac->row_stride,
+				   callback, param);
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_desc_submit_2d - queue a transfer of row_cnt rows of
+ *        row_size bytes, each starting row_stride bytes after the last
+ *******************************************************************************/
+int32_t axi_dmac_desc_submit_2d(axi_dmac_t *dmac, uint64_t address, uint32_t row_size,
+				uint32_t row_cnt, uint32_t row_stride,
+				axi_dmac_desc_callback_t callback, void *param)
+{
+	if ((row_size == 0) || (row_cnt == 0))
 		return FAILURE;
-	}
+
+	return axi_dmac_desc_queue(dmac, address, row_size * row_cnt, row_size, row_stride,
+				   callback, param);
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_set_stride - lay out subsequent 1D submissions, including
+ *        those made with axi_dmac_transfer_nonblocking, as rows of row_size
+ *        bytes spaced row_stride bytes apart. row_size 0 restores contiguous
+ *        transfers.
+ *******************************************************************************/
+int32_t axi_dmac_set_stride(axi_dmac_t *dmac, uint32_t row_size, uint32_t row_stride)
+{
+	uint32_t cpsr;
+
+	if ((row_size != 0) && ((dmac->y_max == 0) || (row_stride < row_size)))
+		return FAILURE;
+
+	cpsr = axi_dmac_lock();
+	dmac->row_size = row_size;
+	dmac->row_stride = row_stride;
+	axi_dmac_unlock(cpsr);
+
 	return SUCCESS;
 }
 
 /***************************************************************************//**
- * @brief axi_dmac_is_transfer_ready
+ * @brief axi_dmac_is_2d_supported
  *******************************************************************************/
-int32_t axi_dmac_is_transfer_ready(axi_dmac_t *dmac, bool *rdy)
+int32_t axi_dmac_is_2d_supported(axi_dmac_t *dmac, bool *supported)
 {
-	*rdy = dmac->big_transfer.transfer_done;
+	*supported = (dmac->y_max != 0);
 
 	return SUCCESS;
 }
 
 /***************************************************************************//**
- * @brief axi_dmac_transfer
+ * @brief axi_dmac_desc_free - number of descriptors that can be submitted
  *******************************************************************************/
-int32_t axi_dmac_transfer(axi_dmac_t *dmac, uint32_t address, uint32_t size)
+int32_t axi_dmac_desc_free(axi_dmac_t *dmac, uint32_t *free)
+{
+	*free = AXI_DMAC_DESC_RING_SIZE - (dmac->desc_head - dmac->desc_tail);
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_set_irq_coalesce - complete up to desc_cnt descriptors per
+ *        interrupt by merging those contiguous in memory into one hardware
+ *        transfer, sot_irq false masks the start of transfer interrupt so
+ *        only EOT interrupts are raised. Merging applies to 1D descriptors,
+ *        which then complete together with the timestamp of the last.
+ *******************************************************************************/
+int32_t axi_dmac_set_irq_coalesce(axi_dmac_t *dmac, uint32_t desc_cnt, bool sot_irq)
 {
-	uint32_t transfer_id;
 	uint32_t reg_val;
-	uint32_t timeout = 0;
+	uint32_t cpsr;
 
-	if (size == 0)
-	{
-	  axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
-		return SUCCESS;
-	}
+	if (desc_cnt > AXI_DMAC_DESC_RING_SIZE)
+		return FAILURE;
 
-	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
-	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
+	cpsr = axi_dmac_lock();
 
-	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
+	dmac->coalesce_cnt = (desc_cnt == 0) ? 1 : desc_cnt;
+	dmac->irq_mask = sot_irq ? 0x0 : AXI_DMAC_IRQ_SOT;
 
-	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &transfer_id);
-	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
-	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
+	axi_dmac_read(dmac, AXI_DMAC_REG_CTRL, &reg_val);
+	if (reg_val & AXI_DMAC_CTRL_ENABLE)
+		axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, dmac->irq_mask);
 
-	switch (dmac->direction)
-	{
-	case DMA_DEV_TO_MEM:
-		axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS, address);
-		axi_dmac_write(dmac, AXI_DMAC_REG_DEST_STRIDE, 0x0);
-		break;
+	axi_dmac_unlock(cpsr);
 
-	case DMA_MEM_TO_DEV:
-		axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS, address);
-		axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, 0x0);
-		break;
+	return SUCCESS;
+}
 
-	default:
-		return FAILURE; // Other directions are not supported yet
-	}
+/***************************************************************************//**
+ * @brief axi_dmac_set_callback - event callback invoked from the ISR for each
+ *        completed descriptor and start of transfer, NULL detaches the owner
+ *        set by axi_dmac_init
+ *******************************************************************************/
+int32_t axi_dmac_set_callback(axi_dmac_t *dmac, axi_dmac_callback_t callback, void *param)
+{
+	uint32_t cpsr = axi_dmac_lock();
+
+	dmac->Callback = callback;
+	dmac->CallbackRef = param;
 
-	if ((size - 1) > dmac->transfer_max_size)
+	axi_dmac_unlock(cpsr);
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_set_desc_callback - completion callback for transfers
+ *        queued with axi_dmac_transfer_nonblocking
+ *******************************************************************************/
+int32_t axi_dmac_set_desc_callback(axi_dmac_t *dmac, axi_dmac_desc_callback_t callback, void *param)
+{
+	uint32_t cpsr = axi_dmac_lock();
+
+	dmac->desc_callback = callback;
+	dmac->desc_callback_ref = param;
+
+	axi_dmac_unlock(cpsr);
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_transfer_nonblock
+ *******************************************************************************/
+int32_t axi_dmac_transfer_nonblocking(axi_dmac_t *dmac, uint32_t address, uint32_t size)
+{
+	uint32_t cpsr;
+
+	if (size == 0)
 	{
-		dmac->big_transfer.address = address;
-		dmac->big_transfer.size = size - 1;
-		dmac->big_transfer.size_done = dmac->transfer_max_size;
+		/* Disabling the core flushes the hardware queue. */
+		cpsr = axi_dmac_lock();
+		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
+		axi_dmac_desc_reset(dmac);
+		axi_dmac_unlock(cpsr);
+		return SUCCESS;
+	}
 
-		axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, dmac->transfer_max_size);
-		axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+	return axi_dmac_desc_submit(dmac, address, size, dmac->desc_callback, dmac->desc_callback_ref);
+}
 
-		axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, dmac->flags);
+/***************************************************************************//**
+ * @brief axi_dmac_is_transfer_ready
+ *******************************************************************************/
+int32_t axi_dmac_is_transfer_ready(axi_dmac_t *dmac, bool *rdy)
+{
+	*rdy = dmac->big_transfer.transfer_done;
 
-		axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
+	return SUCCESS;
+}
 
-		while(!dmac->big_transfer.transfer_done)
-		{
-			timeout++;
-			if (timeout == UINT32_MAX)
-				return FAILURE;
-		}
+/***************************************************************************//**
+ * @brief axi_dmac_transfer_signal - wake the task blocked in axi_dmac_transfer
+ *******************************************************************************/
+static void axi_dmac_transfer_signal(axi_dmac_desc_t *desc, void *param)
+{
+	axi_dmac_t *dmac = (axi_dmac_t *)param;
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
-		dmac->big_transfer.address = 0;
-		dmac->big_transfer.size = 0;
-		dmac->big_transfer.size_done = 0;
+	xSemaphoreGiveFromISR((SemaphoreHandle_t)dmac->wait_sem, &xHigherPriorityTaskWoken);
 
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_transfer_timeout - start a transfer and block until it
+ *        completes or timeout_ms elapses. The calling task sleeps when the
+ *        interrupt is connected and the scheduler is running, otherwise the
+ *        core is polled.
+ *******************************************************************************/
+int32_t axi_dmac_transfer_timeout(axi_dmac_t *dmac, uint32_t address, uint32_t size, uint32_t timeout_ms)
+{
+	uint64_t deadline;
+	uint32_t reg_val;
+	uint32_t cpsr;
+	bool sleep;
+
+	if (size == 0)
+	{
+		cpsr = axi_dmac_lock();
+		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
+		axi_dmac_desc_reset(dmac);
+		axi_dmac_unlock(cpsr);
 		return SUCCESS;
 	}
 
-	axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, size - 1);
-	axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+	sleep = dmac->irq_connected && (dmac->wait_sem != NULL) &&
+		(xTaskGetSchedulerState() == taskSCHEDULER_RUNNING);
+
+	cpsr = axi_dmac_lock();
+	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
+	axi_dmac_desc_reset(dmac);
+	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
+	axi_dmac_unlock(cpsr);
+
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, dmac->irq_mask);
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
 
-	axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, dmac->flags);
+	/* Discard a completion left over from an earlier timed out transfer. */
+	if (sleep)
+		xSemaphoreTake((SemaphoreHandle_t)dmac->wait_sem, 0);
 
-	axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
+	if (axi_dmac_desc_submit(dmac, address, size,
+				 sleep ? axi_dmac_transfer_signal : NULL, dmac) != SUCCESS)
+		return FAILURE;
 
 	if (dmac->flags & DMA_CYCLIC)
 		return SUCCESS;
 
-	/* Wait until the new transfer is queued. */
-	do
+	if (sleep)
 	{
-		axi_dmac_read(dmac, AXI_DMAC_REG_START_TRANSFER, &reg_val);
-	} while(reg_val == 1);
-
-	/* Wait until the current transfer is completed. */
-	do
+		if (xSemaphoreTake((SemaphoreHandle_t)dmac->wait_sem, pdMS_TO_TICKS(timeout_ms)) == pdPASS)
+			return SUCCESS;
+	}
+	else
 	{
-		axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
-		if (reg_val == (AXI_DMAC_IRQ_SOT | AXI_DMAC_IRQ_EOT))
-			break;
-	} while(!dmac->big_transfer.transfer_done);
+		deadline = Timestamp_Get() + ((uint64_t)timeout_ms * (TIMESTAMP_FREQ_HZ / 1000));
+
+		while (Timestamp_Get() < deadline)
+		{
+			/* Retire and queue segments here, the interrupt may be
+			   connected but is masked until the scheduler starts. */
+			cpsr = axi_dmac_lock();
+			axi_dmac_desc_complete(dmac, Timestamp_Get());
+			axi_dmac_desc_fill(dmac);
+			axi_dmac_unlock(cpsr);
+
+			if (dmac->big_transfer.transfer_done)
+				return SUCCESS;
+		}
+	}
 
-	if (reg_val != (AXI_DMAC_IRQ_SOT | AXI_DMAC_IRQ_EOT))
-		axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
+	/* Timed out, abort the transfer. */
+	cpsr = axi_dmac_lock();
+	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
+	axi_dmac_desc_reset(dmac);
+	axi_dmac_unlock(cpsr);
 
-	/* Wait until the transfer with the ID transfer_id is completed. */
-	do
-	{
-		axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_DONE, &reg_val);
-	} while((reg_val & (1u << transfer_id)) != (1u << transfer_id));
+	return FAILURE;
+}
 
-	return SUCCESS;
+/***************************************************************************//**
+ * @brief axi_dmac_transfer
+ *******************************************************************************/
+int32_t axi_dmac_transfer(axi_dmac_t *dmac, uint32_t address, uint32_t size)
+{
+	return axi_dmac_transfer_timeout(dmac, address, size, AXI_DMAC_TRANSFER_TIMEOUT_MS);
 }
 
 /***************************************************************************//**
@@ -321,7 +762,7 @@ int32_t axi_dmac_init(axi_dmac_t **dmac_core, axi_dmac_init_t *init)
 {
 	axi_dmac_t *dmac;
 
-	dmac = (axi_dmac_t *)malloc(sizeof(*dmac));
+	dmac = (axi_dmac_t *)MemPool_Alloc(sizeof(*dmac));
 	if (!dmac)
 		return FAILURE;
 
@@ -331,15 +772,48 @@ int32_t axi_dmac_init(axi_dmac_t **dmac_core, axi_dmac_init_t *init)
 	dmac->direction = init->direction;
 	dmac->flags = init->flags;
 	dmac->transfer_max_size = -1;
-	dmac->big_transfer.address = 0;
-	dmac->big_transfer.size = 0;
-	dmac->big_transfer.size_done = 0;
+	dmac->big_transfer.transfer_done = false;
+	dmac->sot_timestamp = 0;
+	dmac->eot_timestamp = 0;
+	dmac->desc_callback = NULL;
+	dmac->desc_callback_ref = NULL;
+	dmac->irq_connected = (init->irqInstance != NULL);
+	dmac->wait_sem = xSemaphoreCreateBinary();
+	axi_dmac_desc_reset(dmac);
 
 	axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, dmac->transfer_max_size);
 	axi_dmac_read(dmac, AXI_DMAC_REG_X_LENGTH, &dmac->transfer_max_size);
 
+	/* Y_LENGTH reads back as zero when the core is built without 2D support. */
+	axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, -1);
+	axi_dmac_read(dmac, AXI_DMAC_REG_Y_LENGTH, &dmac->y_max);
+	axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+
+	/* ADDRESS_HIGH reads back as zero on a core with a 32-bit address bus. */
+	axi_dmac_write(dmac, (dmac->direction == DMA_DEV_TO_MEM) ?
+		       AXI_DMAC_REG_DEST_ADDRESS_HIGH : AXI_DMAC_REG_SRC_ADDRESS_HIGH, -1);
+	axi_dmac_read(dmac, (dmac->direction == DMA_DEV_TO_MEM) ?
+		      AXI_DMAC_REG_DEST_ADDRESS_HIGH : AXI_DMAC_REG_SRC_ADDRESS_HIGH, &dmac->addr_high_mask);
+	axi_dmac_write(dmac, (dmac->direction == DMA_DEV_TO_MEM) ?
+		       AXI_DMAC_REG_DEST_ADDRESS_HIGH : AXI_DMAC_REG_SRC_ADDRESS_HIGH, 0x0);
+	dmac->row_size = 0;
+	dmac->row_stride = 0;
+	dmac->irq_mask = 0;
+	dmac->coalesce_cnt = 1;
+	dmac->completing = false;
+
 	*dmac_core = dmac;
 
+	/* Register instance so other layers can look it up by base address */
+	for (int i = 0; i < AXI_DMAC_MAX_INSTANCES; i++)
+	{
+		if (axi_dmac_instance[i] == NULL)
+		{
+			axi_dmac_instance[i] = dmac;
+			break;
+		}
+	}
+
 	if( init->irqInstance != NULL )
 	{
 	  XScuGic_Connect((XScuGic*)init->irqInstance, init->irqId, (XInterruptHandler)axi_dmac_default_isr, dmac );
@@ -357,7 +831,35 @@ int32_t axi_dmac_remove(axi_dmac_t *dmac)
 	if(!dmac)
 		return FAILURE;
 
-	free(dmac);
+	for (int i = 0; i < AXI_DMAC_MAX_INSTANCES; i++)
+	{
+		if (axi_dmac_instance[i] == dmac)
+			axi_dmac_instance[i] = NULL;
+	}
+
+	if (dmac->wait_sem != NULL)
+		vSemaphoreDelete((SemaphoreHandle_t)dmac->wait_sem);
+
+	MemPool_Free(dmac);
 
 	return SUCCESS;
 }
+
+/***************************************************************************//**
+ * @brief axi_dmac_get_instance
+ *******************************************************************************/
+int32_t axi_dmac_get_instance(uint32_t base, axi_dmac_t **dmac)
+{
+	for (int i = 0; i < AXI_DMAC_MAX_INSTANCES; i++)
+	{
+		if ((axi_dmac_instance[i] != NULL) && (axi_dmac_instance[i]->base == base))
+		{
+			*dmac = axi_dmac_instance[i];
+			return SUCCESS;
+		}
+	}
+
+	*dmac = NULL;
+
+	return FAILURE;
+}
@@ -67,6 +67,15 @@
 #define AXI_DMAC_REG_DEST_STRIDE  0x420
 #define AXI_DMAC_REG_SRC_STRIDE   0x424
 #define AXI_DMAC_REG_TRANSFER_DONE  0x428
+#define AXI_DMAC_REG_DEST_ADDRESS_HIGH  0x490
+#define AXI_DMAC_REG_SRC_ADDRESS_HIGH 0x494
+
+#define AXI_DMAC_MAX_INSTANCES    8
+
+#define AXI_DMAC_DESC_RING_SIZE   16  /* Software descriptors per instance, power of two */
+#define AXI_DMAC_HW_QUEUE_DEPTH   4   /* Transfers queued in hardware, one per transfer ID */
+#define AXI_DMAC_TRANSFER_TIMEOUT_MS  5000  /* Blocking transfer timeout */
+#define AXI_DMAC_CHUNK_ALIGN      64  /* Alignment of the chunks a large transfer is split into */
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -95,6 +104,34 @@ typedef struct {
 
 typedef void (*axi_dmac_callback_t)( axi_dmac_evt_type_t evt, void *param );
 
+typedef struct axi_dmac_desc axi_dmac_desc_t;
+
+typedef void (*axi_dmac_desc_callback_t)( axi_dmac_desc_t *desc, void *param );
+
+/* Software transfer descriptor. A 1D descriptor larger than
+ * transfer_max_size + 1 bytes is split into chunks planned at submission,
+ * runs of chunk_rows chunks of chunk_size bytes are queued as one 2D
+ * segment when the core supports it. A 2D descriptor is a single segment
+ * of size / row_size rows, each starting row_stride bytes after the last. */
+struct axi_dmac_desc {
+  uint64_t                      address;
+  uint32_t                      size;
+  uint32_t                      size_queued;
+  uint32_t                      row_size;     /* 0 = contiguous */
+  uint32_t                      row_stride;
+  uint32_t                      chunk_size;
+  uint32_t                      chunk_rows;
+  axi_dmac_desc_callback_t      callback;
+  void                         *param;
+  uint64_t                      timestamp;    /* End of transfer time */
+};
+
+/* Descriptor segment owned by a hardware transfer ID */
+typedef struct {
+  uint32_t                      desc;
+  bool                          last;
+}axi_dmac_hw_slot_t;
+
 typedef struct {
   axi_dmac_callback_t           Callback;
   void                         *CallbackRef;
@@ -103,6 +140,27 @@ typedef struct {
   uint32_t                      flags;
   uint32_t                      transfer_max_size;
   volatile axi_dmac_transfer_t  big_transfer;
+  volatile uint64_t             sot_timestamp;
+  volatile uint64_t             eot_timestamp;
+  axi_dmac_desc_t               desc[AXI_DMAC_DESC_RING_SIZE];
+  volatile uint32_t             desc_head;    /* Next descriptor to submit */
+  volatile uint32_t             desc_queue;   /* Next descriptor to hand to hardware */
+  volatile uint32_t             desc_tail;    /* Oldest outstanding descriptor */
+  axi_dmac_hw_slot_t            hw[AXI_DMAC_HW_QUEUE_DEPTH];
+  volatile uint32_t             hw_head;      /* Transfer ID of oldest outstanding segment */
+  volatile uint32_t             hw_count;     /* Segments queued in hardware */
+  volatile bool                 sot_armed;    /* Next start of transfer begins from idle */
+  axi_dmac_desc_callback_t      desc_callback;
+  void                         *desc_callback_ref;
+  bool                          irq_connected;
+  void                         *wait_sem;     /* Signalled when a blocking transfer completes */
+  uint32_t                      y_max;        /* Largest Y_LENGTH, 0 = 2D transfers not supported */
+  uint32_t                      row_size;     /* Row layout applied to 1D submissions, 0 = contiguous */
+  uint32_t                      row_stride;
+  uint32_t                      irq_mask;     /* IRQ_MASK written when the core is enabled */
+  uint32_t                      coalesce_cnt; /* Contiguous descriptors merged into one hardware transfer */
+  volatile bool                 completing;   /* Descriptor callbacks running, refill at end of ISR */
+  uint32_t                      addr_high_mask; /* Writable ADDRESS_HIGH bits, 0 = 32-bit core */
 }axi_dmac_t;
 
 typedef struct {
@@ -122,9 +180,19 @@ void axi_dmac_default_isr(void *instance);
 int32_t axi_dmac_read(axi_dmac_t *dmac, uint32_t reg_addr, uint32_t *reg_data);
 int32_t axi_dmac_write(axi_dmac_t *dmac, uint32_t reg_addr, uint32_t reg_data);
 int32_t axi_dmac_transfer_nonblocking(axi_dmac_t *dmac,  uint32_t address, uint32_t size);
+int32_t axi_dmac_desc_submit(axi_dmac_t *dmac, uint64_t address, uint32_t size, axi_dmac_desc_callback_t callback, void *param);
+int32_t axi_dmac_desc_submit_2d(axi_dmac_t *dmac, uint64_t address, uint32_t row_size, uint32_t row_cnt, uint32_t row_stride, axi_dmac_desc_callback_t callback, void *param);
+int32_t axi_dmac_desc_free(axi_dmac_t *dmac, uint32_t *free);
+int32_t axi_dmac_set_stride(axi_dmac_t *dmac, uint32_t row_size, uint32_t row_stride);
+int32_t axi_dmac_is_2d_supported(axi_dmac_t *dmac, bool *supported);
+int32_t axi_dmac_set_irq_coalesce(axi_dmac_t *dmac, uint32_t desc_cnt, bool sot_irq);
+int32_t axi_dmac_set_callback(axi_dmac_t *dmac, axi_dmac_callback_t callback, void *param);
+int32_t axi_dmac_set_desc_callback(axi_dmac_t *dmac, axi_dmac_desc_callback_t callback, void *param);
 int32_t axi_dmac_is_transfer_ready(axi_dmac_t *dmac, bool *rdy);
 int32_t axi_dmac_transfer(axi_dmac_t *dmac, uint32_t address, uint32_t size);
+int32_t axi_dmac_transfer_timeout(axi_dmac_t *dmac, uint32_t address, uint32_t size, uint32_t timeout_ms);
 int32_t axi_dmac_init(axi_dmac_t **adc_core, axi_dmac_init_t *init);
 int32_t axi_dmac_remove(axi_dmac_t *dmac);
+int32_t axi_dmac_get_instance(uint32_t base, axi_dmac_t **dmac);
 
 #endif
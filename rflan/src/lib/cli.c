@@ -230,10 +230,10 @@ static int Cli_StrToNum(char *p, CliParamType_t type, void *param )
 
 static void CliStr2Num(Cli_t *CliInstance, const char *cmd, void *param )
 {
-  char *type = calloc(1, 32 );
+  char type[32] = {0};
   Cli_GetParameter(cmd, 1, CliParamTypeStr, type);
 
-  char *str = calloc(1, 32 );
+  char str[32] = {0};
   Cli_GetParameter(cmd, 2, CliParamTypeStr, str);
 
   if(strcmp(type, "c") == 0)
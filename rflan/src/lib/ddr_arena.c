@@ -0,0 +1,222 @@
+/***************************************************************************//**
+*  \addtogroup DDR_ARENA
+*   @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       ddr_arena.c
+*
+*  \details    This file contains the DDR arena.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "ddr_arena.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "xstatus.h"
+
+#define DDR_ARENA_ROUND(x,a)      (((x) + (a) - 1) & ~((a) - 1))
+
+/**
+**  DDR Arena Region
+*/
+struct ddr_arena_region
+{
+  uint8_t              *Base;           ///< First byte of region
+  uint32_t              Next;           ///< Offset of next allocation
+  ddr_arena_stats_t     Stats;          ///< Statistics
+};
+
+/* Defined by the .ddr_arena section of lscript.ld */
+extern uint8_t __ddr_arena_start[];
+extern uint8_t __ddr_arena_end[];
+
+static ddr_arena_region_t DdrArenaRegion[DDR_ARENA_REGION_MAX];
+static uint32_t           DdrArenaRegionCnt;
+static uint32_t           DdrArenaAssigned;   ///< Bytes of the arena given to regions
+
+static ddr_arena_region_t *DdrArena_Find( const char *Name )
+{
+  for( uint32_t i = 0; i < DdrArenaRegionCnt; i++ )
+  {
+    if( strncmp( DdrArenaRegion[i].Stats.Name, Name, DDR_ARENA_NAME_LEN ) == 0 )
+      return &DdrArenaRegion[i];
+  }
+
+  return NULL;
+}
+
+ddr_arena_region_t *DdrArena_CreateRegion( const char *Name, uint32_t Size )
+{
+  ddr_arena_region_t *Region = NULL;
+  uint32_t ArenaSize = __ddr_arena_end - __ddr_arena_start;
+
+  if( (Name == NULL) || (strlen( Name ) >= DDR_ARENA_NAME_LEN) || (Size == 0) || (Size > ArenaSize) )
+    return NULL;
+
+  Size = DDR_ARENA_ROUND( Size, DDR_ARENA_ALIGN );
+
+  vTaskSuspendAll();
+
+  if( (DdrArenaRegionCnt < DDR_ARENA_REGION_MAX) && (DdrArena_Find( Name ) == NULL) &&
+      (Size <= (ArenaSize - DdrArenaAssigned)) )
+  {
+    Region = &DdrArenaRegion[DdrArenaRegionCnt++];
+
+    Region->Base = &__ddr_arena_start[DdrArenaAssigned];
+    Region->Next = 0;
+    Region->Stats = (ddr_arena_stats_t){ .Base = (uintptr_t)Region->Base, .Size = Size };
+    strcpy( Region->Stats.Name, Name );
+
+    DdrArenaAssigned += Size;
+  }
+
+  xTaskResumeAll();
+
+  return Region;
+}
+
+ddr_arena_region_t *DdrArena_FindRegion( const char *Name )
+{
+  ddr_arena_region_t *Region;
+
+  if( Name == NULL )
+    return NULL;
+
+  vTaskSuspendAll();
+
+  Region = DdrArena_Find( Name );
+
+  xTaskResumeAll();
+
+  return Region;
+}
+
+void *DdrArena_Alloc( ddr_arena_region_t *Region, uint32_t Size, uint32_t Align )
+{
+  void *Buf = NULL;
+  uint32_t Offset;
+
+  if( Region == NULL )
+    return NULL;
+
+  if( Align < DDR_ARENA_ALIGN )
+    Align = DDR_ARENA_ALIGN;
+
+  vTaskSuspendAll();
+
+  /* Align the address, the region base is only aligned to DDR_ARENA_ALIGN */
+  Offset = DDR_ARENA_ROUND( (uintptr_t)Region->Base + Region->Next, Align ) - (uintptr_t)Region->Base;
+
+  if( (Size != 0) && ((Align & (Align - 1)) == 0) && (Offset <= Region->Stats.Size) &&
+      (DDR_ARENA_ROUND( Size, DDR_ARENA_ALIGN ) <= (Region->Stats.Size - Offset)) )
+  {
+    Buf = &Region->Base[Offset];
+    Region->Next = Offset + DDR_ARENA_ROUND( Size, DDR_ARENA_ALIGN );
+
+    Region->Stats.Used = Region->Next;
+    Region->Stats.AllocCnt++;
+
+    if( Region->Stats.Used > Region->Stats.HighWater )
+      Region->Stats.HighWater = Region->Stats.Used;
+  }
+  else
+  {
+    Region->Stats.FailCnt++;
+  }
+
+  xTaskResumeAll();
+
+  return Buf;
+}
+
+void DdrArena_Reset( ddr_arena_region_t *Region )
+{
+  if( Region == NULL )
+    return;
+
+  vTaskSuspendAll();
+
+  Region->Next = 0;
+  Region->Stats.Used = 0;
+  Region->Stats.ResetCnt++;
+
+  xTaskResumeAll();
+}
+
+void DdrArena_ResetAll( void )
+{
+  vTaskSuspendAll();
+
+  for( uint32_t i = 0; i < DdrArenaRegionCnt; i++ )
+  {
+    DdrArenaRegion[i].Next = 0;
+    DdrArenaRegion[i].Stats.Used = 0;
+    DdrArenaRegion[i].Stats.ResetCnt++;
+  }
+
+  xTaskResumeAll();
+}
+
+int32_t DdrArena_GetStats( uint32_t Idx, ddr_arena_stats_t *Stats )
+{
+  int32_t status = XST_FAILURE;
+
+  if( Stats == NULL )
+    return XST_FAILURE;
+
+  vTaskSuspendAll();
+
+  if( Idx < DdrArenaRegionCnt )
+  {
+    *Stats = DdrArenaRegion[Idx].Stats;
+    status = XST_SUCCESS;
+  }
+
+  xTaskResumeAll();
+
+  return status;
+}
+
+void DdrArena_GetInfo( uint32_t *Size, uint32_t *Free )
+{
+  uint32_t ArenaSize = __ddr_arena_end - __ddr_arena_start;
+
+  if( Size != NULL )
+    *Size = ArenaSize;
+
+  if( Free != NULL )
+    *Free = ArenaSize - DdrArenaAssigned;
+}
@@ -0,0 +1,177 @@
+#ifndef DDR_ARENA_H_
+#define DDR_ARENA_H_
+/***************************************************************************//**
+*  \ingroup    LIB
+*  \defgroup   DDR_ARENA DDR Arena
+*  @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       ddr_arena.h
+*
+*  \details
+*
+*  This file contains the definitions for the DDR arena.  The linker script
+*  reserves a NOLOAD section of DDR for sample buffers that is not shared with
+*  the heap.  The arena is divided into named regions when the modules that
+*  own them are initialized, so every region that is created at startup has
+*  its capacity for as long as the radio runs.  Buffers are allocated from a
+*  region in order and are released together by resetting the region.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+
+#define DDR_ARENA_ALIGN           (64)          ///< Minimum alignment, multiple of the cache line size
+#define DDR_ARENA_REGION_MAX      (8)           ///< Number of regions that can be created
+#define DDR_ARENA_NAME_LEN        (16)          ///< Region name length including terminator
+
+/**
+**  DDR Arena Region
+*/
+typedef struct ddr_arena_region ddr_arena_region_t;
+
+/**
+**  DDR Arena Region Statistics
+*/
+typedef struct
+{
+  char              Name[DDR_ARENA_NAME_LEN]; ///< Region name
+  uintptr_t         Base;             ///< Address of first byte
+  uint32_t          Size;             ///< Region size in bytes
+  uint32_t          Used;             ///< Bytes currently allocated including alignment
+  uint32_t          HighWater;        ///< Maximum value of Used
+  uint32_t          AllocCnt;         ///< Number of successful allocations
+  uint32_t          FailCnt;          ///< Number of failed allocations
+  uint32_t          ResetCnt;         ///< Number of times the region was reset
+} ddr_arena_stats_t;
+
+/*******************************************************************************
+*
+* \details
+*
+* This function creates a named region from the unused part of the arena.
+* Regions can not be removed.
+*
+* \param[in]  Name is the region name, at most DDR_ARENA_NAME_LEN - 1 characters
+*
+* \param[in]  Size is the region size in bytes, rounded up to DDR_ARENA_ALIGN
+*
+* \return     Region or NULL if the name is in use or the arena is exhausted
+*
+*******************************************************************************/
+ddr_arena_region_t *DdrArena_CreateRegion( const char *Name, uint32_t Size );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function finds a region by name.
+*
+* \param[in]  Name is the region name
+*
+* \return     Region or NULL if there is no region with that name
+*
+*******************************************************************************/
+ddr_arena_region_t *DdrArena_FindRegion( const char *Name );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function allocates a buffer from a region.  The buffer is rounded up
+* to whole cache lines so no other buffer shares its lines.
+*
+* \param[in]  Region is the region
+*
+* \param[in]  Size is the number of bytes requested
+*
+* \param[in]  Align is the alignment, a power of two.  Values below
+*             DDR_ARENA_ALIGN use DDR_ARENA_ALIGN.
+*
+* \return     Pointer to buffer or NULL if the region is exhausted
+*
+*******************************************************************************/
+void *DdrArena_Alloc( ddr_arena_region_t *Region, uint32_t Size, uint32_t Align );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function releases every buffer allocated from a region.  The caller
+* must not use them afterwards.
+*
+* \param[in]  Region is the region
+*
+*******************************************************************************/
+void DdrArena_Reset( ddr_arena_region_t *Region );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function releases every buffer of every region.  The regions remain.
+* It is only safe while no stream, record or playback is running.
+*
+*******************************************************************************/
+void DdrArena_ResetAll( void );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function gets the statistics of a region.
+*
+* \param[in]  Idx is the region index in creation order
+*
+* \param[out] Stats is the statistics of the region
+*
+* \return     XST_SUCCESS or XST_FAILURE if there is no region Idx
+*
+*******************************************************************************/
+int32_t DdrArena_GetStats( uint32_t Idx, ddr_arena_stats_t *Stats );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function gets the size of the arena and the bytes not yet assigned to
+* a region.
+*
+* \param[out] Size is the arena size in bytes
+*
+* \param[out] Free is the number of bytes not in any region
+*
+*******************************************************************************/
+void DdrArena_GetInfo( uint32_t *Size, uint32_t *Free );
+
+#endif /* DDR_ARENA_H_ */
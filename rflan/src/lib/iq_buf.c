@@ -0,0 +1,276 @@
+/***************************************************************************//**
+*  \addtogroup IQ_BUF
+*   @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       iq_buf.c
+*
+*  \details    This file contains the IQ buffer allocator implementation.  The
+*              arena is managed as an address ordered list of free blocks,
+*              allocated first fit and merged with their neighbours when freed.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "iq_buf.h"
+#include "ddr_arena.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "xil_cache.h"
+#include "xstatus.h"
+
+#define IQ_BUF_MAGIC              (0x49514246)  ///< Marks the header of an allocated block
+#define IQ_BUF_ROUND(x)           (((x) + IQ_BUF_ALIGN - 1) & ~(IQ_BUF_ALIGN - 1))
+
+/**
+**  IQ Buffer Header
+**
+**  Occupies a whole cache line in front of every block so the header is never
+**  in a line the DMA writes.
+*/
+typedef struct iq_buf_hdr
+{
+  uint32_t              Magic;        ///< IQ_BUF_MAGIC while allocated
+  uint32_t              Size;         ///< Block size including header
+  struct iq_buf_hdr    *Next;         ///< Next free block by address
+} __attribute__((aligned(IQ_BUF_ALIGN))) iq_buf_hdr_t;
+
+static uint8_t         *IqBufArena;   ///< Drawn from the IqBuf region of the DDR arena
+static iq_buf_hdr_t    *IqBufFree;    ///< Free list ordered by address
+static iq_buf_stats_t   IqBufStats;
+
+void *IqBuf_Alloc( uint32_t Size )
+{
+  iq_buf_hdr_t **Prev;
+  iq_buf_hdr_t *Blk;
+  void *Buf = NULL;
+
+  if( (Size == 0) || (Size > IQ_BUF_ARENA_SIZE) )
+    return NULL;
+
+  /* Whole cache lines plus header */
+  Size = IQ_BUF_ROUND( Size ) + sizeof(iq_buf_hdr_t);
+
+  vTaskSuspendAll();
+
+  for( Prev = &IqBufFree; (Blk = *Prev) != NULL; Prev = &Blk->Next )
+  {
+    if( Blk->Size < Size )
+      continue;
+
+    /* Split if the remainder can hold a header and one line */
+    if( (Blk->Size - Size) >= (sizeof(iq_buf_hdr_t) + IQ_BUF_ALIGN) )
+    {
+      iq_buf_hdr_t *Rem = (iq_buf_hdr_t *)((uint8_t *)Blk + Size);
+
+      Rem->Size = Blk->Size - Size;
+      Rem->Next = Blk->Next;
+      Rem->Magic = 0;
+      Blk->Size = Size;
+      *Prev = Rem;
+    }
+    else
+    {
+      *Prev = Blk->Next;
+    }
+
+    Blk->Magic = IQ_BUF_MAGIC;
+    Blk->Next = NULL;
+
+    IqBufStats.Used += Blk->Size;
+    IqBufStats.AllocCnt++;
+
+    if( IqBufStats.Used > IqBufStats.HighWater )
+      IqBufStats.HighWater = IqBufStats.Used;
+
+    Buf = Blk + 1;
+    break;
+  }
+
+  if( Buf == NULL )
+    IqBufStats.FailCnt++;
+
+  xTaskResumeAll();
+
+  return Buf;
+}
+
+/* Insert a block in the address ordered free list and merge it with its
+   neighbours, called with the scheduler suspended */
+static void IqBuf_Insert( iq_buf_hdr_t *Blk )
+{
+  /* Find neighbours by address */
+  iq_buf_hdr_t *Before = NULL;
+  iq_buf_hdr_t *After = IqBufFree;
+
+  while( (After != NULL) && (After < Blk) )
+  {
+    Before = After;
+    After = After->Next;
+  }
+
+  Blk->Next = After;
+
+  if( Before == NULL )
+    IqBufFree = Blk;
+  else
+    Before->Next = Blk;
+
+  /* Merge with following block */
+  if( (After != NULL) && ((uint8_t *)Blk + Blk->Size == (uint8_t *)After) )
+  {
+    Blk->Size += After->Size;
+    Blk->Next = After->Next;
+  }
+
+  /* Merge with preceding block */
+  if( (Before != NULL) && ((uint8_t *)Before + Before->Size == (uint8_t *)Blk) )
+  {
+    Before->Size += Blk->Size;
+    Before->Next = Blk->Next;
+  }
+}
+
+void IqBuf_Free( void *Buf )
+{
+  iq_buf_hdr_t *Blk;
+
+  if( Buf == NULL )
+    return;
+
+  Blk = (iq_buf_hdr_t *)Buf - 1;
+
+  /* Ignore pointers that were not returned by IqBuf_Alloc */
+  if( (IqBufArena == NULL) || ((uint8_t *)Blk < IqBufArena) || ((uint8_t *)Blk >= &IqBufArena[IQ_BUF_ARENA_SIZE]) ||
+      (Blk->Magic != IQ_BUF_MAGIC) )
+    return;
+
+  vTaskSuspendAll();
+
+  Blk->Magic = 0;
+
+  IqBufStats.Used -= Blk->Size;
+  IqBufStats.FreeCnt++;
+
+  IqBuf_Insert( Blk );
+
+  xTaskResumeAll();
+}
+
+void IqBuf_Shrink( void *Buf, uint32_t Size )
+{
+  iq_buf_hdr_t *Blk;
+  iq_buf_hdr_t *Rem;
+
+  if( (Buf == NULL) || (Size == 0) )
+    return;
+
+  Blk = (iq_buf_hdr_t *)Buf - 1;
+
+  if( (IqBufArena == NULL) || ((uint8_t *)Blk < IqBufArena) || ((uint8_t *)Blk >= &IqBufArena[IQ_BUF_ARENA_SIZE]) ||
+      (Blk->Magic != IQ_BUF_MAGIC) )
+    return;
+
+  Size = IQ_BUF_ROUND( Size ) + sizeof(iq_buf_hdr_t);
+
+  vTaskSuspendAll();
+
+  /* Return the tail if it can hold a header and one line */
+  if( (Size <= Blk->Size) && ((Blk->Size - Size) >= (sizeof(iq_buf_hdr_t) + IQ_BUF_ALIGN)) )
+  {
+    Rem = (iq_buf_hdr_t *)((uint8_t *)Blk + Size);
+    Rem->Magic = 0;
+    Rem->Size = Blk->Size - Size;
+    Blk->Size = Size;
+
+    IqBufStats.Used -= Rem->Size;
+
+    IqBuf_Insert( Rem );
+  }
+
+  xTaskResumeAll();
+}
+
+void IqBuf_Flush( const void *Buf, uint32_t Size )
+{
+  if( (Buf != NULL) && (Size > 0) )
+    Xil_DCacheFlushRange( (INTPTR)Buf, Size );
+}
+
+void IqBuf_Invalidate( void *Buf, uint32_t Size )
+{
+  if( (Buf != NULL) && (Size > 0) )
+    Xil_DCacheInvalidateRange( (INTPTR)Buf, Size );
+}
+
+int32_t IqBuf_GetStats( iq_buf_stats_t *Stats )
+{
+  if( Stats == NULL )
+    return XST_FAILURE;
+
+  vTaskSuspendAll();
+
+  *Stats = IqBufStats;
+  Stats->LargestFree = 0;
+
+  for( iq_buf_hdr_t *Blk = IqBufFree; Blk != NULL; Blk = Blk->Next )
+  {
+    if( (Blk->Size - sizeof(iq_buf_hdr_t)) > Stats->LargestFree )
+      Stats->LargestFree = Blk->Size - sizeof(iq_buf_hdr_t);
+  }
+
+  xTaskResumeAll();
+
+  return XST_SUCCESS;
+}
+
+int32_t IqBuf_Initialize( void )
+{
+  ddr_arena_region_t *Region;
+
+  if((Region = DdrArena_CreateRegion( IQ_BUF_REGION_NAME, IQ_BUF_ARENA_SIZE )) == NULL)
+    return XST_FAILURE;
+
+  if((IqBufArena = DdrArena_Alloc( Region, IQ_BUF_ARENA_SIZE, IQ_BUF_ALIGN )) == NULL)
+    return XST_FAILURE;
+
+  IqBufFree = (iq_buf_hdr_t *)IqBufArena;
+  IqBufFree->Magic = 0;
+  IqBufFree->Size = IQ_BUF_ARENA_SIZE;
+  IqBufFree->Next = NULL;
+
+  IqBufStats = (iq_buf_stats_t){ .Size = IQ_BUF_ARENA_SIZE };
+
+  return XST_SUCCESS;
+}
@@ -0,0 +1,167 @@
+#ifndef IQ_BUF_H_
+#define IQ_BUF_H_
+/***************************************************************************//**
+*  \ingroup    LIB
+*  \defgroup   IQ_BUF IQ Buffer
+*  @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       iq_buf.h
+*
+*  \details
+*
+*  This file contains the definitions for allocating IQ sample buffers that are
+*  shared with the DMA.  Buffers are served from a DDR arena reserved for
+*  sample data, start on a cache line boundary and are padded to a whole number
+*  of cache lines so cache maintenance on one buffer never touches another.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+
+#define IQ_BUF_ALIGN              (64)          ///< Buffer alignment, multiple of the cache line size
+#define IQ_BUF_ARENA_SIZE         (0x1000000)   ///< Bytes of DDR reserved for IQ buffers
+#define IQ_BUF_REGION_NAME        "IqBuf"       ///< DDR arena region holding the IQ buffers
+
+/**
+**  IQ Buffer Statistics
+*/
+typedef struct
+{
+  uint32_t          Size;             ///< Arena size in bytes
+  uint32_t          Used;             ///< Bytes currently allocated including headers
+  uint32_t          HighWater;        ///< Maximum value of Used
+  uint32_t          LargestFree;      ///< Largest buffer that can currently be allocated
+  uint32_t          AllocCnt;         ///< Number of successful allocations
+  uint32_t          FreeCnt;          ///< Number of buffers freed
+  uint32_t          FailCnt;          ///< Number of failed allocations
+} iq_buf_stats_t;
+
+/*******************************************************************************
+*
+* \details
+*
+* This function allocates a buffer from the IQ arena.  The buffer is aligned to
+* IQ_BUF_ALIGN and no other buffer shares its cache lines.
+*
+* \param[in]  Size is the number of bytes requested
+*
+* \return     Pointer to buffer or NULL if the arena is exhausted
+*
+*******************************************************************************/
+void *IqBuf_Alloc( uint32_t Size );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function returns a buffer to the IQ arena.  NULL is ignored.
+*
+* \param[in]  Buf is a buffer returned by IqBuf_Alloc
+*
+*******************************************************************************/
+void IqBuf_Free( void *Buf );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function returns the end of a buffer to the IQ arena when fewer bytes
+* were needed than allocated.  The buffer keeps its address.
+*
+* \param[in]  Buf is a buffer returned by IqBuf_Alloc
+*
+* \param[in]  Size is the number of bytes to keep
+*
+*******************************************************************************/
+void IqBuf_Shrink( void *Buf, uint32_t Size );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function writes the cache lines covering a range of a buffer back to
+* memory and discards them.  It must be called after the processor writes
+* samples and before the DMA reads them.  It must also be called before the
+* DMA writes a buffer the processor may have written earlier, so no dirty line
+* is evicted over the samples while the DMA runs.
+*
+* \param[in]  Buf is the first byte the DMA will access
+*
+* \param[in]  Size is the number of bytes the DMA will access
+*
+*******************************************************************************/
+void IqBuf_Flush( const void *Buf, uint32_t Size );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function discards the cache lines covering a range of a buffer.  It must
+* be called after the DMA writes samples and before the processor reads them.
+* Buffers the processor filled, such as a copy out of a DMA staging buffer,
+* must not be invalidated as their samples may only be in the cache.
+*
+* \param[in]  Buf is the first byte written by the DMA
+*
+* \param[in]  Size is the number of bytes written by the DMA
+*
+*******************************************************************************/
+void IqBuf_Invalidate( void *Buf, uint32_t Size );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function returns the arena usage statistics.
+*
+* \param[out] Stats is the returned statistics
+*
+* \return     Status
+*
+*******************************************************************************/
+int32_t IqBuf_GetStats( iq_buf_stats_t *Stats );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function reserves the IQ arena as the IqBuf region of the DDR arena and
+* initializes it as a single free block.
+*
+* \return     Status
+*
+*******************************************************************************/
+int32_t IqBuf_Initialize( void );
+
+#endif /* IQ_BUF_H_ */
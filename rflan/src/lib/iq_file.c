@@ -41,130 +41,505 @@
 *
 *******************************************************************************/
 #include <string.h>
+#include <strings.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include "iq_file.h"
+#include "iq_buf.h"
+#include "iq_rice.h"
+#include "timestamp.h"
+#include "parameters.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
 #include "ff.h"
 #include "xstatus.h"
 
-#define IQ_FILE_MAX_LINE_SIZE       (64)
+#define IQ_FILE_BIN_CHUNK_SAMPLES   (512)     ///< Samples converted per binary file write
+#define IQ_FILE_READ_BLOCK_SIZE     (0x8000)  ///< Bytes read from a csv file per f_read
+#define IQ_FILE_CSV_MIN_LINE        (4)       ///< Characters of the shortest csv sample line
+#define IQ_FILE_CSV_MAX_LINE        (16)      ///< Characters of the longest csv sample line
+#define IQ_FILE_WRITE_BLOCK_SIZE    (0x8000)  ///< Bytes of csv text formatted per f_write
+#define IQ_FILE_SECTOR_SIZE         (512)     ///< File system sector size
+#define IQ_FILE_SIGMF_META_SIZE     (1024)    ///< Bytes of SigMF metadata text
+#define IQ_FILE_SIGMF_VERSION       "1.0.0"   ///< SigMF specification version
+#define IQ_FILE_SIGMF_HW            "BytePipe_x900x RFLAN"
+#define IQ_FILE_CRC_POLY            (0xEDB88320)
+
+/**
+**  IQ File Block Reader
+*/
+typedef struct
+{
+  FIL                  *fil;            ///< File
+  char                 *Buf;            ///< Block of the file
+  UINT                  Len;            ///< Bytes in Buf
+  UINT                  Pos;            ///< Next byte of Buf
+} iq_file_reader_t;
+
+/**
+**  IQ File Write Request
+*/
+typedef struct
+{
+  const char           *filename;       ///< File to create
+  uint32_t             *Buf;            ///< Samples
+  uint32_t              Length;         ///< Number of samples
+  iq_file_meta_t        Meta;           ///< Binary header fields
+  bool                  HasMeta;        ///< Meta is valid
+  iq_file_callback_t    Callback;       ///< Called once the file is closed
+  void                 *CallbackRef;    ///< User data
+} iq_file_write_req_t;
+
+static uint32_t IqFileCrcTable[256];
+static QueueHandle_t IqFileWriteQueue;
+static TaskHandle_t IqFileTask;
+
+static uint32_t IqFile_Crc32( uint32_t Crc, const void *Buf, uint32_t Size )
+{
+  const uint8_t *Data = (const uint8_t *)Buf;
+
+  if( IqFileCrcTable[1] == 0 )
+  {
+    for( uint32_t i = 0; i < 256; i++ )
+    {
+      uint32_t c = i;
+
+      for( int k = 0; k < 8; k++ )
+        c = (c & 1) ? (IQ_FILE_CRC_POLY ^ (c >> 1)) : (c >> 1);
+
+      IqFileCrcTable[i] = c;
+    }
+  }
+
+  Crc = ~Crc;
+
+  while( Size-- > 0 )
+    Crc = IqFileCrcTable[(Crc ^ *Data++) & 0xff] ^ (Crc >> 8);
 
-static int32_t IqFile_ReadLine( FIL *fil, char *line, int size )
+  return ~Crc;
+}
+
+static bool IqFile_HasExt( const char* filename, const char* ext )
+{
+  size_t len = strlen( filename );
+  size_t extlen = strlen( ext );
+
+  return (len > extlen) && (strcasecmp( &filename[len - extlen], ext ) == 0);
+}
+
+bool IqFile_IsBinary( const char* filename )
 {
-  UINT len = 1;
-  char c;
+  return IqFile_HasExt( filename, IQ_FILE_BIN_EXT ) || IqFile_HasExt( filename, IQ_FILE_RICE_EXT );
+}
+
+uint32_t IqFile_GetFormat( const char* filename )
+{
+  return IqFile_HasExt( filename, IQ_FILE_RICE_EXT ) ? IQ_FILE_FORMAT_CI16_RICE : IQ_FILE_FORMAT_CI16;
+}
 
-  while((len > 0) && (size > 0))
+bool IqFile_IsSigMF( const char* filename )
+{
+  return IqFile_HasExt( filename, IQ_FILE_SIGMF_EXT );
+}
+
+int32_t IqFile_ReadHdr( FIL *fil, iq_file_hdr_t *Hdr )
+{
+  UINT len;
+
+  if(f_lseek(fil, 0) != FR_OK)
+    return XST_FAILURE;
+
+  if((f_read(fil, Hdr, sizeof(iq_file_hdr_t), &len) != FR_OK) || (len != sizeof(iq_file_hdr_t)))
+    return XST_FAILURE;
+
+  if( (Hdr->Magic != IQ_FILE_BIN_MAGIC) || (Hdr->Version != IQ_FILE_BIN_VERSION) ||
+      (Hdr->HeaderSize != sizeof(iq_file_hdr_t)) ||
+      ((Hdr->Format != IQ_FILE_FORMAT_CI16) && (Hdr->Format != IQ_FILE_FORMAT_CI16_RICE)) )
+    return XST_FAILURE;
+
+  if( Hdr->HeaderCrc != IqFile_Crc32( 0, Hdr, offsetof(iq_file_hdr_t, HeaderCrc) ) )
+    return XST_FAILURE;
+
+  /* Uncompressed data is exactly one word per sample */
+  if( (Hdr->SampleCnt > UINT32_MAX) ||
+      ((Hdr->Format == IQ_FILE_FORMAT_CI16) && (Hdr->DataSize != Hdr->SampleCnt * sizeof(uint32_t))) ||
+      (f_size(fil) < ((FSIZE_t)Hdr->HeaderSize + Hdr->DataSize)) )
+    return XST_FAILURE;
+
+  return XST_SUCCESS;
+}
+
+/* Next character of the file, the block is refilled with one multi sector
+   read when it is empty.  Returns -1 at the end of the file. */
+static inline int IqFile_GetChar( iq_file_reader_t *Reader )
+{
+  if( Reader->Pos == Reader->Len )
   {
-    f_read(fil, (void*)&c, 1, &len);
+    if( (f_read(Reader->fil, Reader->Buf, IQ_FILE_READ_BLOCK_SIZE, &Reader->Len) != FR_OK) || (Reader->Len == 0) )
+    {
+      Reader->Len = 0;
+      return -1;
+    }
 
-    if(len == 0)
+    Reader->Pos = 0;
+  }
+
+  return (uint8_t)Reader->Buf[Reader->Pos++];
+}
+
+static int32_t IqFile_ReaderOpen( iq_file_reader_t *Reader, FIL *fil )
+{
+  if((Reader->Buf = IqBuf_Alloc( IQ_FILE_READ_BLOCK_SIZE )) == NULL)
+    return XST_FAILURE;
+
+  Reader->fil = fil;
+  Reader->Len = 0;
+  Reader->Pos = 0;
+
+  if(f_lseek(fil, 0) != FR_OK)
+  {
+    IqBuf_Free( Reader->Buf );
+    return XST_FAILURE;
+  }
+
+  return XST_SUCCESS;
+}
+
+static void IqFile_ReaderClose( iq_file_reader_t *Reader )
+{
+  IqBuf_Free( Reader->Buf );
+  Reader->Buf = NULL;
+}
+
+/* Parse "I, Q" lines into 32 bit IQ words.  Blank lines are skipped, a line
+   that is not two integers fails the parse.  Values are truncated to 16 bits
+   so files holding unsigned 16 bit values are also accepted. */
+static int32_t IqFile_ParseCsv( FIL *fil, uint32_t *SampleBuf, uint32_t Capacity, uint32_t *SampleCnt )
+{
+  iq_file_reader_t Reader;
+  uint32_t Cnt = 0;
+  uint32_t Field = 0;
+  int32_t Value[2] = {0, 0};
+  bool Neg = false;
+  bool Digits = false;
+  bool Empty = true;
+  int c;
+
+  if(IqFile_ReaderOpen( &Reader, fil ) != XST_SUCCESS)
+    return XST_FAILURE;
+
+  do
+  {
+    c = IqFile_GetChar( &Reader );
+
+    if( (c >= '0') && (c <= '9') )
     {
-      return XST_FAILURE;
+      Value[Field] = Value[Field] * 10 + (c - '0');
+      Digits = true;
+      Empty = false;
+    }
+    else if( ((c == '-') || (c == '+')) && !Digits && !Neg )
+    {
+      Neg = (c == '-');
+      Empty = false;
+    }
+    else if( (c == ' ') || (c == '\t') || (c == '\r') )
+    {
+      continue;
+    }
+    else if( (c == ',') && (Field == 0) && Digits )
+    {
+      Value[0] = Neg ? -Value[0] : Value[0];
+      Field = 1;
+      Neg = false;
+      Digits = false;
+    }
+    else if( ((c == '\n') || (c < 0)) && Empty )
+    {
+      continue;
+    }
+    else if( ((c == '\n') || (c < 0)) && (Field == 1) && Digits && (Cnt < Capacity) )
+    {
+      Value[1] = Neg ? -Value[1] : Value[1];
+      SampleBuf[Cnt++] = (((uint32_t)Value[0] & 0xffff) << 16) | ((uint32_t)Value[1] & 0xffff);
+
+      Value[0] = 0;
+      Value[1] = 0;
+      Field = 0;
+      Neg = false;
+      Digits = false;
+      Empty = true;
     }
     else
     {
-      *line = c;
-      line++;
-      size--;
-
-      if( c == '\n' )
-      {
-        *line = 0;
-        return XST_SUCCESS;
-      }
+      IqFile_ReaderClose( &Reader );
+      return XST_FAILURE;
     }
-  }
+  } while( c >= 0 );
 
-  return XST_FAILURE;
+  IqFile_ReaderClose( &Reader );
+
+  *SampleCnt = Cnt;
+
+  return XST_SUCCESS;
 }
 
 int32_t IqFile_GetSampleCnt( FIL *fil, uint32_t *SampleCnt )
 {
-  UINT len = 1;
-  char c;
+  iq_file_reader_t Reader;
+  int c;
   uint32_t cnt = 0;
+  iq_file_hdr_t Hdr;
 
-  if(f_lseek(fil, 0) != FR_OK)
+  /* Binary file */
+  if(IqFile_ReadHdr( fil, &Hdr ) == XST_SUCCESS)
+  {
+    *SampleCnt = (uint32_t)Hdr.SampleCnt;
+    return XST_SUCCESS;
+  }
+
+  if(IqFile_ReaderOpen( &Reader, fil ) != XST_SUCCESS)
     return XST_FAILURE;
 
-  while( len > 0 )
+  while( (c = IqFile_GetChar( &Reader )) >= 0 )
   {
-    f_read(fil, (void*)&c, 1, &len);
-
     if( c == ',' )
       cnt++;
   }
 
+  IqFile_ReaderClose( &Reader );
+
   *SampleCnt = cnt;
 
   return XST_SUCCESS;
 }
 
-static int32_t IqFile_ReadSample( FIL *fil, uint32_t *Sample )
+/* Read interleaved int16 I and Q samples starting at Offset into a new
+   buffer, Crc receives the CRC-32 of the file bytes if not NULL */
+static int32_t IqFile_ReadCi16( FIL *fil, FSIZE_t Offset, uint32_t SampleCnt, uint32_t **Buf, uint32_t *Crc )
+{
+  uint32_t *SampleBuf;
+  UINT len;
+
+  if( SampleCnt == 0 )
+    return XST_FAILURE;
+
+  if((SampleBuf = IqBuf_Alloc(SampleCnt * sizeof(uint32_t))) == NULL)
+    return XST_FAILURE;
+
+  /* Samples are read in one request so the file system transfers whole
+     clusters directly into the buffer */
+  if((f_lseek(fil, Offset) != FR_OK) ||
+     (f_read(fil, SampleBuf, SampleCnt * sizeof(uint32_t), &len) != FR_OK) ||
+     (len != SampleCnt * sizeof(uint32_t)))
+  {
+    IqBuf_Free(SampleBuf);
+    return XST_FAILURE;
+  }
+
+  if( Crc != NULL )
+    *Crc = IqFile_Crc32( 0, SampleBuf, SampleCnt * sizeof(uint32_t) );
+
+  for( uint32_t i = 0; i < SampleCnt; i++ )
+    SampleBuf[i] = IQ_FILE_SWAP_IQ(SampleBuf[i]);
+
+  *Buf = SampleBuf;
+
+  return XST_SUCCESS;
+}
+
+/* Decode DataSize bytes of Rice coded blocks at the file position.  The data
+   is streamed through one read block, refilled whenever less than a whole
+   coded block remains. */
+static int32_t IqFile_ReadRice( FIL *fil, uint32_t DataSize, uint32_t SampleCnt, uint32_t **Buf, uint32_t *Crc )
+{
+  uint8_t *Block;
+  uint32_t *SampleBuf;
+  uint32_t Cnt, Used;
+  UINT Fill = 0;
+  UINT Pos = 0;
+  UINT Size;
+  UINT len;
+  int32_t status = XST_SUCCESS;
+
+  if( SampleCnt == 0 )
+    return XST_FAILURE;
+
+  if((SampleBuf = IqBuf_Alloc(SampleCnt * sizeof(uint32_t))) == NULL)
+    return XST_FAILURE;
+
+  if((Block = IqBuf_Alloc( IQ_FILE_READ_BLOCK_SIZE )) == NULL)
+  {
+    IqBuf_Free(SampleBuf);
+    return XST_FAILURE;
+  }
+
+  *Crc = 0;
+
+  for( uint32_t i = 0; i < SampleCnt; i += Cnt )
+  {
+    if( ((Fill - Pos) < IQ_RICE_BLOCK_MAX_SIZE) && (DataSize > 0) )
+    {
+      memmove( Block, &Block[Pos], Fill - Pos );
+      Fill -= Pos;
+      Pos = 0;
+
+      Size = ((IQ_FILE_READ_BLOCK_SIZE - Fill) < DataSize) ? (IQ_FILE_READ_BLOCK_SIZE - Fill) : DataSize;
+
+      if((f_read(fil, &Block[Fill], Size, &len) != FR_OK) || (len != Size))
+      {
+        status = XST_FAILURE;
+        break;
+      }
+
+      *Crc = IqFile_Crc32( *Crc, &Block[Fill], Size );
+      Fill += Size;
+      DataSize -= Size;
+    }
+
+    Cnt = ((SampleCnt - i) < IQ_RICE_BLOCK_SAMPLES) ? (SampleCnt - i) : IQ_RICE_BLOCK_SAMPLES;
+
+    if((status = IqRice_DecodeBlock( &Block[Pos], Fill - Pos, &SampleBuf[i], Cnt, &Used )) != XST_SUCCESS)
+      break;
+
+    Pos += Used;
+  }
+
+  IqBuf_Free( Block );
+
+  /* All of the data must belong to the samples */
+  if( (status != XST_SUCCESS) || (Pos != Fill) || (DataSize != 0) )
+  {
+    IqBuf_Free(SampleBuf);
+    return XST_FAILURE;
+  }
+
+  *Buf = SampleBuf;
+
+  return XST_SUCCESS;
+}
+
+static int32_t IqFile_ReadBin( FIL *fil, uint32_t **Buf, uint32_t *Length, iq_file_meta_t *Meta )
 {
-  char line[IQ_FILE_MAX_LINE_SIZE] = {0};
+  iq_file_hdr_t Hdr;
+  uint32_t *SampleBuf;
+  uint32_t SampleCnt;
+  uint32_t Crc;
 
-  if(IqFile_ReadLine( fil, line, sizeof(line) ) != XST_SUCCESS)
+  if(IqFile_ReadHdr( fil, &Hdr ) != XST_SUCCESS)
     return XST_FAILURE;
 
-  int32_t idata;
-  int32_t qdata;
+  SampleCnt = (uint32_t)Hdr.SampleCnt;
 
-  char *iq = strtok(line,",");
-  sscanf( iq, "%li", (int32_t*)&idata );
+  if( Hdr.Format == IQ_FILE_FORMAT_CI16_RICE )
+  {
+    if((f_lseek(fil, Hdr.HeaderSize) != FR_OK) ||
+       (IqFile_ReadRice( fil, Hdr.DataSize, SampleCnt, &SampleBuf, &Crc ) != XST_SUCCESS))
+      return XST_FAILURE;
+  }
+  else if(IqFile_ReadCi16( fil, Hdr.HeaderSize, SampleCnt, &SampleBuf, &Crc ) != XST_SUCCESS)
+  {
+    return XST_FAILURE;
+  }
+
+  if( Crc != Hdr.DataCrc )
+  {
+    IqBuf_Free(SampleBuf);
+    return XST_FAILURE;
+  }
 
-  iq = strtok(NULL,",");
-  sscanf( iq, "%li", (int32_t*)&qdata );
-  *Sample = (((uint32_t)idata & 0xffff) << 16) | ((uint32_t)qdata & 0xffff);
+  if( Meta != NULL )
+  {
+    Meta->SampleRate      = Hdr.SampleRate;
+    Meta->CarrierFreq     = Hdr.CarrierFreq;
+    Meta->Port            = Hdr.Port;
+    Meta->StartTimestamp  = Hdr.StartTimestamp;
+  }
+
+  *Buf = SampleBuf;
+  *Length = SampleCnt;
 
   return XST_SUCCESS;
 }
 
-int32_t IqFile_Read( const char* filename, uint32_t **Buf, uint32_t *Length )
+int32_t IqFile_Read( const char* filename, uint32_t **Buf, uint32_t *Length, iq_file_meta_t *Meta )
 {
   FIL fil;
   int32_t status;
-  uint32_t cnt = 0;
+  uint32_t Capacity;
   uint32_t *SampleBuf = NULL;
   uint32_t SampleCnt = 0;
 
   *Length = SampleCnt;
   *Buf = SampleBuf;
 
+  if( Meta != NULL )
+    memset( Meta, 0, sizeof(iq_file_meta_t) );
+
   do
   {
     /* Open File */
     if((status = f_open(&fil, filename, FA_OPEN_EXISTING | FA_READ)) != FR_OK) break;
 
-    /* Get Number of Samples */
-    if((status = IqFile_GetSampleCnt( &fil, &SampleCnt )) != XST_SUCCESS) break;
+    /* Binary File */
+    if( IqFile_IsBinary( filename ) )
+    {
+      status = IqFile_ReadBin( &fil, Buf, Length, Meta );
+      f_close(&fil);
+      return status;
+    }
 
-    /* Allocate Buffer */
-    if((SampleBuf = malloc(SampleCnt * sizeof(uint32_t))) == NULL)
+    /* SigMF Dataset, the metadata is not read */
+    if( IqFile_IsSigMF( filename ) )
     {
-      status = XST_FAILURE;
-      break;
+      SampleCnt = (uint32_t)(f_size(&fil) / sizeof(uint32_t));
+
+      if((status = IqFile_ReadCi16( &fil, 0, SampleCnt, &SampleBuf, NULL )) != XST_SUCCESS) break;
+
+      f_close(&fil);
+
+      *Length = SampleCnt;
+      *Buf = SampleBuf;
+
+      return XST_SUCCESS;
     }
 
-    /* Pointer to beginning of file */
-    if((status = f_lseek(&fil, 0)) != FR_OK) break;
+    /* Every sample takes at least 4 characters, "0,0\n", so the file size
+       bounds the sample count and the file is parsed in a single pass */
+    Capacity = (uint32_t)((f_size(&fil) + 1) / IQ_FILE_CSV_MIN_LINE);
 
-    while(cnt < SampleCnt)
+    if((SampleBuf = IqBuf_Alloc(Capacity * sizeof(uint32_t))) == NULL)
     {
-      if(( status = IqFile_ReadSample( &fil, &SampleBuf[cnt] )) != XST_SUCCESS )
+      /* Arena can not hold the bound, count the samples first */
+      if((status = IqFile_GetSampleCnt( &fil, &Capacity )) != XST_SUCCESS) break;
+
+      if((SampleBuf = IqBuf_Alloc(Capacity * sizeof(uint32_t))) == NULL)
+      {
+        status = XST_FAILURE;
         break;
+      }
+    }
 
-      cnt++;
+    if((status = IqFile_ParseCsv( &fil, SampleBuf, Capacity, &SampleCnt )) != XST_SUCCESS) break;
+
+    if( SampleCnt == 0 )
+    {
+      status = XST_FAILURE;
+      break;
     }
 
+    /* Return the unused part of the estimate */
+    IqBuf_Shrink( SampleBuf, SampleCnt * sizeof(uint32_t) );
+
   }while(0);
 
   f_close(&fil);
 
   if( status != XST_SUCCESS)
   {
-    free(SampleBuf);
+    IqBuf_Free(SampleBuf);
   }
   else
   {
@@ -175,40 +550,385 @@ int32_t IqFile_Read( const char* filename, uint32_t **Buf, uint32_t *Length )
   return status;
 }
 
-int32_t IqFile_Write( const char* filename, uint32_t *Buf, uint32_t Length )
+/* Write samples as interleaved int16 I and Q at the file position, Crc is
+   updated with the written bytes if not NULL */
+static int32_t IqFile_WriteCi16( FIL *fil, uint32_t *Buf, uint32_t Length, uint32_t *Crc )
 {
-  FIL fil;
-  UINT len = 0;
+  uint32_t Chunk[IQ_FILE_BIN_CHUNK_SAMPLES];
+  uint32_t Cnt;
+  UINT len;
+
+  for( uint32_t i = 0; i < Length; i += Cnt )
+  {
+    Cnt = ((Length - i) < IQ_FILE_BIN_CHUNK_SAMPLES) ? (Length - i) : IQ_FILE_BIN_CHUNK_SAMPLES;
+
+    for( uint32_t k = 0; k < Cnt; k++ )
+      Chunk[k] = IQ_FILE_SWAP_IQ(Buf[i + k]);
+
+    if( Crc != NULL )
+      *Crc = IqFile_Crc32( *Crc, Chunk, Cnt * sizeof(uint32_t) );
+
+    if((f_write(fil, Chunk, Cnt * sizeof(uint32_t), &len) != FR_OK) || (len != Cnt * sizeof(uint32_t)))
+      return XST_FAILURE;
+  }
+
+  return XST_SUCCESS;
+}
+
+/* Fill the header fields common to every binary file */
+static void IqFile_InitHdr( iq_file_hdr_t *Hdr, uint32_t Format, uint64_t SampleCnt, const iq_file_meta_t *Meta )
+{
+  memset( Hdr, 0, sizeof(iq_file_hdr_t) );
+
+  Hdr->Magic         = IQ_FILE_BIN_MAGIC;
+  Hdr->Version       = IQ_FILE_BIN_VERSION;
+  Hdr->HeaderSize    = sizeof(iq_file_hdr_t);
+  Hdr->Format        = Format;
+  Hdr->TimestampFreq = TIMESTAMP_FREQ_HZ;
+  Hdr->SampleCnt     = SampleCnt;
+
+  if( Meta != NULL )
+  {
+    Hdr->SampleRate      = Meta->SampleRate;
+    Hdr->CarrierFreq     = Meta->CarrierFreq;
+    Hdr->Port            = Meta->Port;
+    Hdr->StartTimestamp  = Meta->StartTimestamp;
+  }
+}
+
+static int32_t IqFile_WriteBin( FIL *fil, uint32_t *Buf, uint32_t Length, uint32_t Format, const iq_file_meta_t *Meta )
+{
+  iq_file_stream_t Stream;
   int32_t status;
 
-  do
+  if(IqFile_StreamOpen( &Stream, fil, Format ) != XST_SUCCESS)
+    return XST_FAILURE;
+
+  /* Buf belongs to the caller, ci16 samples are converted through a chunk */
+  if( Format == IQ_FILE_FORMAT_CI16_RICE )
   {
-    /* Open File */
-    if((status = f_open(&fil, filename, FA_CREATE_ALWAYS | FA_WRITE)) != FR_OK) break;
+    status = IqFile_StreamWrite( &Stream, Buf, Length );
+  }
+  else
+  {
+    status = IqFile_WriteCi16( fil, Buf, Length, &Stream.DataCrc );
 
-    /* Pointer to beginning of file */
-    if((status = f_lseek(&fil, 0)) != FR_OK) break;
+    Stream.SampleCnt  = Length;
+    Stream.DataSize   = Length * sizeof(uint32_t);
+  }
+
+  if(IqFile_StreamClose( &Stream, Meta ) != XST_SUCCESS)
+    status = XST_FAILURE;
+
+  return status;
+}
+
+int32_t IqFile_StreamOpen( iq_file_stream_t *Stream, FIL *fil, uint32_t Format )
+{
+  if( (Stream == NULL) || (fil == NULL) ||
+      ((Format != IQ_FILE_FORMAT_CI16) && (Format != IQ_FILE_FORMAT_CI16_RICE)) )
+    return XST_FAILURE;
+
+  Stream->fil       = fil;
+  Stream->Format    = Format;
+  Stream->SampleCnt = 0;
+  Stream->DataSize  = 0;
+  Stream->DataCrc   = 0;
+  Stream->Block     = NULL;
+  Stream->Fill      = 0;
+
+  /* Reserve header, it is written once the data CRC is known */
+  if(f_lseek(fil, sizeof(iq_file_hdr_t)) != FR_OK)
+    return XST_FAILURE;
+
+  if( (Format == IQ_FILE_FORMAT_CI16_RICE) &&
+      ((Stream->Block = IqBuf_Alloc( IQ_FILE_WRITE_BLOCK_SIZE )) == NULL) )
+    return XST_FAILURE;
+
+  return XST_SUCCESS;
+}
 
-    char line[IQ_FILE_MAX_LINE_SIZE];
-    int16_t idata, qdata;
+/* Write the first Size bytes of the Rice write block */
+static int32_t IqFile_StreamFlush( iq_file_stream_t *Stream, UINT Size )
+{
+  UINT len;
+
+  Stream->DataCrc = IqFile_Crc32( Stream->DataCrc, Stream->Block, Size );
+
+  if((f_write(Stream->fil, Stream->Block, Size, &len) != FR_OK) || (len != Size))
+    return XST_FAILURE;
+
+  memmove( Stream->Block, &Stream->Block[Size], Stream->Fill - Size );
+  Stream->Fill     -= Size;
+  Stream->DataSize += Size;
+
+  return XST_SUCCESS;
+}
+
+/* Append Rice coded blocks, they are collected in the write block and
+   written up to a sector boundary of the file once the next block may not
+   fit.  The header offsets the data from the sectors. */
+static int32_t IqFile_StreamWriteRice( iq_file_stream_t *Stream, uint32_t *Buf, uint32_t Length )
+{
+  uint32_t Cnt, Used;
+  FSIZE_t Pos;
+
+  /* A partial block ends the coded data */
+  if( Stream->SampleCnt % IQ_RICE_BLOCK_SAMPLES )
+    return XST_FAILURE;
 
-    /* Write data to file */
-    for(int i = 0; i < Length; i++)
+  for( uint32_t i = 0; i < Length; i += Cnt )
+  {
+    Cnt = ((Length - i) < IQ_RICE_BLOCK_SAMPLES) ? (Length - i) : IQ_RICE_BLOCK_SAMPLES;
+
+    if(IqRice_EncodeBlock( &Buf[i], Cnt, &Stream->Block[Stream->Fill], &Used ) != XST_SUCCESS)
+      return XST_FAILURE;
+
+    Stream->Fill += Used;
+    Stream->SampleCnt += Cnt;
+
+    if( Stream->Fill > (IQ_FILE_WRITE_BLOCK_SIZE - IQ_RICE_BLOCK_MAX_SIZE) )
     {
-      line[0] = 0;
-      idata = (int16_t)(Buf[i] >> 16);
-      qdata = (int16_t)Buf[i];
+      Pos = f_tell(Stream->fil);
+
+      if(IqFile_StreamFlush( Stream, ((Pos + Stream->Fill) & ~(IQ_FILE_SECTOR_SIZE - 1)) - Pos ) != XST_SUCCESS)
+        return XST_FAILURE;
+    }
+  }
+
+  return XST_SUCCESS;
+}
+
+int32_t IqFile_StreamWrite( iq_file_stream_t *Stream, uint32_t *Buf, uint32_t Length )
+{
+  UINT len;
+
+  if( Stream->Format == IQ_FILE_FORMAT_CI16_RICE )
+    return IqFile_StreamWriteRice( Stream, Buf, Length );
+
+  for( uint32_t i = 0; i < Length; i++ )
+    Buf[i] = IQ_FILE_SWAP_IQ(Buf[i]);
+
+  Stream->DataCrc = IqFile_Crc32( Stream->DataCrc, Buf, Length * sizeof(uint32_t) );
+
+  if((f_write(Stream->fil, Buf, Length * sizeof(uint32_t), &len) != FR_OK) || (len != Length * sizeof(uint32_t)))
+    return XST_FAILURE;
+
+  Stream->SampleCnt += Length;
+  Stream->DataSize  += len;
+
+  return XST_SUCCESS;
+}
+
+int32_t IqFile_StreamClose( iq_file_stream_t *Stream, const iq_file_meta_t *Meta )
+{
+  iq_file_hdr_t Hdr;
+  int32_t status = XST_SUCCESS;
+  UINT len;
+
+  /* Remainder of the Rice write block */
+  if( Stream->Block != NULL )
+  {
+    if( Stream->Fill > 0 )
+      status = IqFile_StreamFlush( Stream, Stream->Fill );
+
+    IqBuf_Free( Stream->Block );
+    Stream->Block = NULL;
+  }
+
+  if( status != XST_SUCCESS )
+    return status;
+
+  IqFile_InitHdr( &Hdr, Stream->Format, Stream->SampleCnt, Meta );
+
+  Hdr.DataSize  = Stream->DataSize;
+  Hdr.DataCrc   = Stream->DataCrc;
+  Hdr.HeaderCrc = IqFile_Crc32( 0, &Hdr, offsetof(iq_file_hdr_t, HeaderCrc) );
+
+  if((f_lseek(Stream->fil, 0) != FR_OK) ||
+     (f_write(Stream->fil, &Hdr, sizeof(Hdr), &len) != FR_OK) || (len != sizeof(Hdr)) ||
+     (f_lseek(Stream->fil, sizeof(Hdr) + (FSIZE_t)Stream->DataSize) != FR_OK))
+    return XST_FAILURE;
+
+  return XST_SUCCESS;
+}
+
+/* Write an int16 as decimal text, returns the end of the text */
+static inline char *IqFile_FormatS16( char *p, int16_t Value )
+{
+  char Tmp[5];
+  uint32_t u = (Value < 0) ? -(int32_t)Value : Value;
+  int n = 0;
+
+  if( Value < 0 )
+    *p++ = '-';
+
+  do
+  {
+    Tmp[n++] = '0' + (u % 10);
+    u /= 10;
+  } while( u > 0 );
+
+  while( n > 0 )
+    *p++ = Tmp[--n];
 
-      snprintf(line, IQ_FILE_MAX_LINE_SIZE, "%d, %d\r\n", idata, qdata );
+  return p;
+}
 
-      if((status = f_write(&fil, (const void*)line, strlen(line), (UINT*)&len)) != FR_OK) break;
+static int32_t IqFile_WriteCsv( FIL *fil, uint32_t *Buf, uint32_t Length )
+{
+  char *Block;
+  char *p;
+  UINT Fill;
+  UINT len;
+  int32_t status = XST_SUCCESS;
 
-      if(strlen(line) != len)
+  if((Block = IqBuf_Alloc( IQ_FILE_WRITE_BLOCK_SIZE )) == NULL)
+    return XST_FAILURE;
+
+  p = Block;
+
+  for( uint32_t i = 0; i < Length; i++ )
+  {
+    p = IqFile_FormatS16( p, (int16_t)(Buf[i] >> 16) );
+    *p++ = ',';
+    *p++ = ' ';
+    p = IqFile_FormatS16( p, (int16_t)Buf[i] );
+    *p++ = '\r';
+    *p++ = '\n';
+
+    /* Write whole sectors once the next line may not fit, the file
+       position stays sector aligned so every write goes straight to the
+       card */
+    Fill = p - Block;
+
+    if( Fill > (IQ_FILE_WRITE_BLOCK_SIZE - IQ_FILE_CSV_MAX_LINE) )
+    {
+      UINT Size = Fill & ~(IQ_FILE_SECTOR_SIZE - 1);
+
+      if((f_write(fil, Block, Size, &len) != FR_OK) || (len != Size))
       {
         status = XST_FAILURE;
         break;
       }
+
+      memmove( Block, &Block[Size], Fill - Size );
+      p = &Block[Fill - Size];
+    }
+  }
+
+  /* Remainder */
+  Fill = p - Block;
+
+  if( (status == XST_SUCCESS) && (Fill > 0) )
+  {
+    if((f_write(fil, Block, Fill, &len) != FR_OK) || (len != Fill))
+      status = XST_FAILURE;
+  }
+
+  IqBuf_Free( Block );
+
+  return status;
+}
+
+/* Write the .sigmf-meta file describing a .sigmf-data file */
+static int32_t IqFile_WriteSigMFMeta( const char* filename, uint32_t Length, const iq_file_meta_t *Meta )
+{
+  static const iq_file_meta_t Unknown = {0};
+  char metaname[FF_FILENAME_MAX_LEN];
+  char Json[IQ_FILE_SIGMF_META_SIZE];
+  size_t extlen = strlen( IQ_FILE_SIGMF_EXT );
+  size_t namelen = strlen( filename ) - extlen;
+  int n;
+  FIL fil;
+  UINT len;
+  int32_t status = XST_SUCCESS;
+
+  if( Meta == NULL )
+    Meta = &Unknown;
+
+  if( (namelen + strlen( IQ_FILE_SIGMF_META_EXT )) >= sizeof(metaname) )
+    return XST_FAILURE;
+
+  memcpy( metaname, filename, namelen );
+  strcpy( &metaname[namelen], IQ_FILE_SIGMF_META_EXT );
+
+  n = snprintf( Json, sizeof(Json),
+      "{\n"
+      "  \"global\": {\n"
+      "    \"core:version\": \"" IQ_FILE_SIGMF_VERSION "\",\n"
+      "    \"core:datatype\": \"ci16_le\",\n"
+      "    \"core:sample_rate\": %lu,\n"
+      "    \"core:num_channels\": 1,\n"
+      "    \"core:hw\": \"" IQ_FILE_SIGMF_HW "\",\n"
+      "    \"core:extensions\": [{\"name\": \"rflan\", \"version\": \"1.0.0\", \"optional\": true}],\n"
+      "    \"rflan:port\": %lu,\n"
+      "    \"rflan:timestamp_freq\": %lu",
+      Meta->SampleRate, Meta->Port, (uint32_t)TIMESTAMP_FREQ_HZ );
+
+  if( Meta->TemperatureValid && (n > 0) && (n < sizeof(Json)) )
+    n += snprintf( &Json[n], sizeof(Json) - n, ",\n    \"rflan:temperature\": %d", Meta->Temperature );
+
+  if( (n > 0) && (n < sizeof(Json)) )
+    n += snprintf( &Json[n], sizeof(Json) - n,
+        "\n"
+        "  },\n"
+        "  \"captures\": [\n"
+        "    {\n"
+        "      \"core:sample_start\": 0,\n"
+        "      \"core:frequency\": %llu,\n"
+        "      \"rflan:timestamp\": %llu,\n"
+        "      \"rflan:sample_count\": %lu\n"
+        "    }\n"
+        "  ],\n"
+        "  \"annotations\": []\n"
+        "}\n",
+        Meta->CarrierFreq, Meta->StartTimestamp, Length );
+
+  if( (n <= 0) || (n >= sizeof(Json)) )
+    return XST_FAILURE;
+
+  if(f_open(&fil, metaname, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
+    return XST_FAILURE;
+
+  if((f_write(&fil, Json, n, &len) != FR_OK) || (len != n))
+    status = XST_FAILURE;
+
+  f_close(&fil);
+
+  return status;
+}
+
+int32_t IqFile_Write( const char* filename, uint32_t *Buf, uint32_t Length, const iq_file_meta_t *Meta )
+{
+  FIL fil;
+  int32_t status;
+
+  do
+  {
+    /* Open File */
+    if((status = f_open(&fil, filename, FA_CREATE_ALWAYS | FA_WRITE)) != FR_OK) break;
+
+    /* Pointer to beginning of file */
+    if((status = f_lseek(&fil, 0)) != FR_OK) break;
+
+    /* Binary File */
+    if( IqFile_IsBinary( filename ) )
+    {
+      status = IqFile_WriteBin( &fil, Buf, Length, IqFile_GetFormat( filename ), Meta );
+      break;
     }
+
+    /* SigMF Dataset and Metadata */
+    if( IqFile_IsSigMF( filename ) )
+    {
+      if((status = IqFile_WriteCi16( &fil, Buf, Length, NULL )) != XST_SUCCESS) break;
+
+      status = IqFile_WriteSigMFMeta( filename, Length, Meta );
+      break;
+    }
+
+    status = IqFile_WriteCsv( &fil, Buf, Length );
   }while(0);
 
   f_close(&fil);
@@ -217,3 +937,55 @@ int32_t IqFile_Write( const char* filename, uint32_t *Buf, uint32_t Length )
 }
 
 
+
+static void IqFile_Task( void *pvParameters )
+{
+  iq_file_write_req_t Req;
+  int32_t status;
+
+  for( ;; )
+  {
+    if( xQueueReceive( IqFileWriteQueue, &Req, portMAX_DELAY ) != pdPASS )
+      continue;
+
+    status = IqFile_Write( Req.filename, Req.Buf, Req.Length, Req.HasMeta ? &Req.Meta : NULL );
+
+    if( Req.Callback != NULL )
+      Req.Callback( status, Req.CallbackRef );
+  }
+}
+
+int32_t IqFile_WriteAsync( const char* filename, uint32_t *Buf, uint32_t Length, const iq_file_meta_t *Meta,
+    iq_file_callback_t Callback, void *CallbackRef )
+{
+  iq_file_write_req_t Req = {
+      .filename     = filename,
+      .Buf          = Buf,
+      .Length       = Length,
+      .HasMeta      = (Meta != NULL),
+      .Callback     = Callback,
+      .CallbackRef  = CallbackRef
+  };
+
+  if( (IqFileWriteQueue == NULL) || (filename == NULL) || (Buf == NULL) )
+    return XST_FAILURE;
+
+  if( Meta != NULL )
+    Req.Meta = *Meta;
+
+  if( xQueueSend( IqFileWriteQueue, &Req, 0 ) != pdPASS )
+    return XST_FAILURE;
+
+  return XST_SUCCESS;
+}
+
+int32_t IqFile_Initialize( void )
+{
+  if((IqFileWriteQueue = xQueueCreate( IQ_FILE_WRITE_QUEUE_SIZE, sizeof(iq_file_write_req_t) )) == NULL)
+    return XST_FAILURE;
+
+  if(xTaskCreate( IqFile_Task, IQ_FILE_TASK_NAME, IQ_FILE_TASK_STACK_SIZE, NULL, IQ_FILE_TASK_PRIORITY, &IqFileTask ) != pdPASS)
+    return XST_FAILURE;
+
+  return XST_SUCCESS;
+}
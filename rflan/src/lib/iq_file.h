@@ -11,7 +11,36 @@
 *  \details
 *
 *  This file contains the definitions for reading and writing IQ data to a fat
-*  file system.
+*  file system.  Files ending in IQ_FILE_BIN_EXT use the binary format,
+*  files ending in IQ_FILE_RICE_EXT use the compressed binary format, files
+*  ending in IQ_FILE_SIGMF_EXT are SigMF recordings and all other files
+*  are csv text with one "I, Q" line per sample.
+*
+*  \section IQ_FILE_BIN Binary Format
+*
+*  A binary file is an iq_file_hdr_t followed by SampleCnt samples.  Each
+*  sample is a little endian int16 I followed by a little endian int16 Q.
+*  HeaderCrc is the CRC-32 (IEEE 802.3, as used by zlib) of the header bytes
+*  before it and DataCrc is the CRC-32 of the DataSize bytes of sample data.
+*  Files with a different Version, HeaderSize or Format are rejected.
+*
+*  \section IQ_FILE_RICE Compressed Binary Format
+*
+*  A compressed file has the binary header with Format IQ_FILE_FORMAT_CI16_RICE.
+*  The sample data is a sequence of blocks in the IQ_RICE_BLOCK format, each
+*  holding IQ_RICE_BLOCK_SAMPLES samples except the last.  Compression is
+*  lossless and a block never grows beyond the ci16 size by more than its
+*  header, narrowband captures that leave the upper bits of the samples
+*  unused shrink the most.
+*
+*  \section IQ_FILE_SIGMF SigMF Recording
+*
+*  Writing name.sigmf-data creates the SigMF dataset, samples in the ci16_le
+*  format of the binary file without a header, and name.sigmf-meta.  The
+*  metadata holds the sample rate and carrier frequency as core fields.  The
+*  port, timestamp of the first sample, timestamp rate and die temperature
+*  have no core equivalent and are stored under the optional "rflan"
+*  extension.  Reading a dataset ignores its metadata.
 *
 *  \copyright
 *
@@ -52,15 +81,89 @@ extern "C"
 #endif
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "ff.h"
 
+#define IQ_FILE_BIN_EXT             ".iq"         ///< Filename extension of binary files
+#define IQ_FILE_BIN_MAGIC           (0x51495042)  ///< "BPIQ" in file byte order
+#define IQ_FILE_BIN_VERSION         (1)           ///< Binary format version
+#define IQ_FILE_FORMAT_CI16         (1)           ///< Interleaved int16 I and Q
+#define IQ_FILE_FORMAT_CI16_RICE    (2)           ///< Rice coded blocks of int16 I and Q
+#define IQ_FILE_RICE_EXT            ".iqz"        ///< Filename extension of compressed binary files
+#define IQ_FILE_SIGMF_EXT           ".sigmf-data" ///< Filename extension of SigMF datasets
+#define IQ_FILE_SIGMF_META_EXT      ".sigmf-meta" ///< Filename extension of SigMF metadata
+
+/* 32 bit IQ words hold I in the upper half, binary files store I first */
+#define IQ_FILE_SWAP_IQ(x)          (((x) << 16) | ((x) >> 16))
+
+/**
+**  IQ File Binary Header
+*/
+typedef struct __attribute__((packed))
+{
+  uint32_t          Magic;            ///< IQ_FILE_BIN_MAGIC
+  uint16_t          Version;          ///< IQ_FILE_BIN_VERSION
+  uint16_t          HeaderSize;       ///< Bytes from start of file to first sample
+  uint32_t          Format;           ///< Sample format, IQ_FILE_FORMAT_CI16
+  uint32_t          SampleRate;       ///< Sample rate in Hz, 0 = unknown
+  uint64_t          CarrierFreq;      ///< Carrier frequency in Hz, 0 = unknown
+  uint32_t          Port;             ///< ADRV9001 port, adrv9001_port_t
+  uint32_t          TimestampFreq;    ///< Rate of StartTimestamp in Hz
+  uint64_t          StartTimestamp;   ///< Timestamp of first sample, 0 = unknown
+  uint64_t          SampleCnt;        ///< Number of samples
+  uint32_t          DataSize;         ///< Bytes of sample data
+  uint32_t          Reserved;         ///< Zero
+  uint32_t          DataCrc;          ///< CRC-32 of the sample data
+  uint32_t          HeaderCrc;        ///< CRC-32 of the preceding header bytes
+} iq_file_hdr_t;
+
+/**
+**  IQ File Metadata
+**
+**  Stored in the header of binary files and the metadata of SigMF
+**  recordings, ignored by csv files.  The binary header has no temperature.
+*/
+typedef struct
+{
+  uint32_t          SampleRate;       ///< Sample rate in Hz, 0 = unknown
+  uint64_t          CarrierFreq;      ///< Carrier frequency in Hz, 0 = unknown
+  uint32_t          Port;             ///< ADRV9001 port
+  uint64_t          StartTimestamp;   ///< Timestamp of first sample in TIMESTAMP_FREQ_HZ ticks, 0 = unknown
+  int16_t           Temperature;      ///< Die temperature in degrees C
+  bool              TemperatureValid; ///< Temperature is known
+} iq_file_meta_t;
+
+/**
+**  IQ File Callback
+**
+**  Called from the IQ file task with the status of IqFile_Write.
+*/
+typedef void (*iq_file_callback_t)( int32_t Status, void *CallbackRef );
+
+/**
+**  IQ File Stream
+**  Writes a binary file block by block when the samples do not fit in memory.
+**  The header is written by IqFile_StreamClose once the sample count and data
+**  CRC are known.
+*/
+typedef struct
+{
+  FIL              *fil;              ///< File, open for writing
+  uint32_t          Format;           ///< Sample format, IQ_FILE_FORMAT_CI16 or IQ_FILE_FORMAT_CI16_RICE
+  uint64_t          SampleCnt;        ///< Samples written
+  uint32_t          DataSize;         ///< Bytes of sample data written
+  uint32_t          DataCrc;          ///< CRC-32 of the sample data
+  uint8_t          *Block;            ///< Rice coded blocks waiting for a sector boundary
+  uint32_t          Fill;             ///< Bytes in Block
+} iq_file_stream_t;
+
 /*******************************************************************************
 *
 * \details
 *
-* This function writes IQ data to a file in csv format.  Existing files with
-* the same filename will be deleted before creating a new file and writing its
-* contents.
+* This function writes IQ data to a file in binary or csv format depending on
+* the filename extension.  Existing files with the same filename will be
+* deleted before creating a new file and writing its contents.
 *
 * \param[in]  filename is the name of the file created.
 *
@@ -68,16 +171,21 @@ extern "C"
 *
 * \param[in]  Length represents the number of samples in Buf
 *
+* \param[in]  Meta is stored in the header of a binary file, NULL = unknown
+*
 * \return     Status
 *
 *******************************************************************************/
-int32_t IqFile_Write( const char* filename, uint32_t *Buf, uint32_t Length );
+int32_t IqFile_Write( const char* filename, uint32_t *Buf, uint32_t Length, const iq_file_meta_t *Meta );
 
 /*******************************************************************************
 *
 * \details
 *
-* This function reads IQ data from a csv formatted file.
+* This function queues IqFile_Write to the IQ file task so the caller, for
+* example a stream callback, returns before the file is written.  filename
+* and Buf must stay valid until Callback is called.  Files are written one at
+* a time in the order they are queued.
 *
 * \param[in]  filename is the name of the file created.
 *
@@ -85,16 +193,47 @@ int32_t IqFile_Write( const char* filename, uint32_t *Buf, uint32_t Length );
 *
 * \param[in]  Length represents the number of samples in Buf
 *
+* \param[in]  Meta is copied, NULL = unknown
+*
+* \param[in]  Callback is called once the file is closed, may be NULL
+*
+* \param[in]  CallbackRef is passed to Callback
+*
+* \return     XST_SUCCESS or XST_FAILURE if the task is not running or its
+*             queue is full, the caller should then use IqFile_Write
+*
+*******************************************************************************/
+int32_t IqFile_WriteAsync( const char* filename, uint32_t *Buf, uint32_t Length, const iq_file_meta_t *Meta,
+    iq_file_callback_t Callback, void *CallbackRef );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function reads IQ data from a binary or csv formatted file depending on
+* the filename extension.  The sample buffer is allocated with IqBuf_Alloc.
+* Binary files with a bad header or data CRC are rejected.
+*
+* \param[in]  filename is the name of the file created.
+*
+* \param[in]  Buf is a buffer containing 32bit IQ samples
+*
+* \param[in]  Length represents the number of samples in Buf
+*
+* \param[out] Meta receives the header fields of a binary file, zero for a csv
+*             file.  May be NULL.
+*
 * \return     Status
 *
 *******************************************************************************/
-int32_t IqFile_Read( const char* filename, uint32_t **Buf, uint32_t *Length );
+int32_t IqFile_Read( const char* filename, uint32_t **Buf, uint32_t *Length, iq_file_meta_t *Meta );
 
 /*******************************************************************************
 *
 * \details
 *
-* This function returns the number of IQ samples from a csv formatted file.
+* This function returns the number of IQ samples from a binary or csv
+* formatted file.  Binary files are recognized by their header.
 *
 * \param[in]  filename is the name of the file created.
 *
@@ -105,4 +244,131 @@ int32_t IqFile_Read( const char* filename, uint32_t **Buf, uint32_t *Length );
 *******************************************************************************/
 int32_t IqFile_GetSampleCnt( FIL *fil, uint32_t *SampleCnt );
 
+/*******************************************************************************
+*
+* \details
+*
+* This function reads and validates the header of a binary file.  The file
+* position is left after the header.
+*
+* \param[in]  fil is the open file
+*
+* \param[out] Hdr receives the header
+*
+* \return     XST_SUCCESS or XST_FAILURE if the file is not a valid binary file
+*
+*******************************************************************************/
+int32_t IqFile_ReadHdr( FIL *fil, iq_file_hdr_t *Hdr );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function starts a binary file stream by reserving the header at the
+* start of fil.  A Rice coded stream allocates a write block that is freed by
+* IqFile_StreamClose.
+*
+* \param[in]  Stream is the stream
+*
+* \param[in]  fil is a file open for writing
+*
+* \param[in]  Format is the sample format, IQ_FILE_FORMAT_CI16 or
+*             IQ_FILE_FORMAT_CI16_RICE
+*
+* \return     Status
+*
+*******************************************************************************/
+int32_t IqFile_StreamOpen( iq_file_stream_t *Stream, FIL *fil, uint32_t Format );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function appends samples to a binary file stream.  Buf is converted to
+* the file sample order in place so a receive block is written in a single
+* f_write, its contents are undefined afterwards.  A Rice coded stream
+* encodes Buf in blocks of IQ_RICE_BLOCK_SAMPLES and writes whole sectors,
+* Buf is left unchanged.  Only the last write of a Rice coded stream may hold
+* a partial block.
+*
+* \param[in]  Stream is the stream
+*
+* \param[in]  Buf is a buffer containing 32bit IQ samples
+*
+* \param[in]  Length represents the number of samples in Buf
+*
+* \return     Status
+*
+*******************************************************************************/
+int32_t IqFile_StreamWrite( iq_file_stream_t *Stream, uint32_t *Buf, uint32_t Length );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function writes the header of a binary file stream.  The file position
+* is left at the end of the sample data so the caller can f_truncate any
+* preallocated space before closing the file.  It must be called once for
+* every successful IqFile_StreamOpen, also after a failed write.
+*
+* \param[in]  Stream is the stream
+*
+* \param[in]  Meta is stored in the header, NULL = unknown
+*
+* \return     Status
+*
+*******************************************************************************/
+int32_t IqFile_StreamClose( iq_file_stream_t *Stream, const iq_file_meta_t *Meta );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function indicates if a filename selects the binary format.
+*
+* \param[in]  filename is the name of the file
+*
+* \return     true if filename ends in IQ_FILE_BIN_EXT or IQ_FILE_RICE_EXT
+*
+*******************************************************************************/
+bool IqFile_IsBinary( const char* filename );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function returns the binary sample format selected by a filename.
+*
+* \param[in]  filename is the name of the file
+*
+* \return     IQ_FILE_FORMAT_CI16_RICE if filename ends in IQ_FILE_RICE_EXT,
+*             IQ_FILE_FORMAT_CI16 otherwise
+*
+*******************************************************************************/
+uint32_t IqFile_GetFormat( const char* filename );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function indicates if a filename selects a SigMF recording.
+*
+* \param[in]  filename is the name of the file
+*
+* \return     true if filename ends in IQ_FILE_SIGMF_EXT
+*
+*******************************************************************************/
+bool IqFile_IsSigMF( const char* filename );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function creates the IQ file task that serves IqFile_WriteAsync.
+*
+* \return     Status
+*
+*******************************************************************************/
+int32_t IqFile_Initialize( void );
+
 #endif /* IQ_FILE_H_ */
@@ -0,0 +1,95 @@
+/***************************************************************************//**
+*  \addtogroup IQ_POWER
+*   @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       iq_power.c
+*
+*  \details    This file contains the IQ power implementation.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+#include "iq_power.h"
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+#include <arm_acle.h>
+
+/* I*I + Q*Q in one dual multiply, the sum only overflows int32 for full scale I and Q */
+#define IQ_POWER(x)             ((uint32_t)__smuad( (int16x2_t)(x), (int16x2_t)(x) ))
+#else
+static inline uint32_t IqPower_Sample( uint32_t x )
+{
+  int32_t i = (int16_t)(x >> 16);
+  int32_t q = (int16_t)(x & 0xffff);
+
+  return (uint32_t)(i * i) + (uint32_t)(q * q);
+}
+
+#define IQ_POWER(x)             IqPower_Sample( x )
+#endif
+
+void IqPower_Block( const uint32_t *Buf, uint32_t SampleCnt, uint64_t *Sum, uint32_t *Peak )
+{
+  uint64_t Acc0 = 0, Acc1 = 0;
+  uint32_t Max0 = 0, Max1 = 0;
+  uint32_t i;
+
+  /* Two independent accumulators keep the multiply pipeline busy */
+  for( i = 0; (i + 4) <= SampleCnt; i += 4 )
+  {
+    uint32_t p0 = IQ_POWER( Buf[i + 0] );
+    uint32_t p1 = IQ_POWER( Buf[i + 1] );
+    uint32_t p2 = IQ_POWER( Buf[i + 2] );
+    uint32_t p3 = IQ_POWER( Buf[i + 3] );
+
+    Acc0 += p0 + (uint64_t)p2;
+    Acc1 += p1 + (uint64_t)p3;
+
+    Max0 = (p0 > Max0) ? p0 : Max0;
+    Max1 = (p1 > Max1) ? p1 : Max1;
+    Max0 = (p2 > Max0) ? p2 : Max0;
+    Max1 = (p3 > Max1) ? p3 : Max1;
+  }
+
+  for( ; i < SampleCnt; i++ )
+  {
+    uint32_t p = IQ_POWER( Buf[i] );
+
+    Acc0 += p;
+    Max0 = (p > Max0) ? p : Max0;
+  }
+
+  *Sum = Acc0 + Acc1;
+  *Peak = (Max0 > Max1) ? Max0 : Max1;
+}
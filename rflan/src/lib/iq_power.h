@@ -0,0 +1,70 @@
+#ifndef IQ_POWER_H_
+#define IQ_POWER_H_
+/***************************************************************************//**
+*  \ingroup    LIB
+*  \defgroup   IQ_POWER IQ Power
+*  @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       iq_power.h
+*
+*  \details
+*
+*  This file contains the definitions for measuring the power of a block of IQ
+*  samples.  Samples are 32 bit words holding a 16 bit I and a 16 bit Q.  The
+*  power of a sample is I*I + Q*Q.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+
+/*******************************************************************************
+*
+* \details
+*
+* This function computes the total and peak power of a block of IQ samples.
+* The dual 16 bit multiply instruction (SMUAD) is used when the target supports
+* the DSP extension.
+*
+* \param[in]  Buf is a buffer containing 32bit IQ samples
+*
+* \param[in]  SampleCnt is the number of samples in Buf
+*
+* \param[out] Sum is the sum of the power of all samples
+*
+* \param[out] Peak is the largest power of a single sample
+*
+*******************************************************************************/
+void IqPower_Block( const uint32_t *Buf, uint32_t SampleCnt, uint64_t *Sum, uint32_t *Peak );
+
+#endif /* IQ_POWER_H_ */
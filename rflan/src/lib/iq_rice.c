@@ -0,0 +1,282 @@
+/***************************************************************************//**
+*  \addtogroup IQ_RICE
+*   @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       iq_rice.c
+*
+*  \details    This file contains the IQ Rice coding implementation.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "iq_rice.h"
+#include "xstatus.h"
+
+#define IQ_RICE_MODE(Order, k)      (((Order) << 5) | (k))
+#define IQ_RICE_MODE_ORDER(Mode)    ((Mode) >> 5)
+#define IQ_RICE_MODE_K(Mode)        ((Mode) & 0x1f)
+
+/**
+**  IQ Rice Bit Stream
+*/
+typedef struct
+{
+  uint8_t              *p;              ///< Next byte
+  const uint8_t        *End;            ///< End of the stream, decoder only
+  uint32_t              Acc;            ///< Pending bits
+  uint32_t              Bits;           ///< Number of pending bits
+} iq_rice_stream_t;
+
+/* Channel of a 32 bit IQ word, 0 = I, 1 = Q */
+static inline int16_t IqRice_Channel( uint32_t x, uint32_t Ch )
+{
+  return (int16_t)(Ch == 0 ? (x >> 16) : x);
+}
+
+/* Map a residual to 0, -1, 1, -2, 2 ... -> 0, 1, 2, 3, 4 ... */
+static inline uint32_t IqRice_ZigZag( int32_t r )
+{
+  int16_t s = (int16_t)r;
+
+  return (uint16_t)(((uint32_t)s << 1) ^ (uint32_t)(s >> 15));
+}
+
+static inline int32_t IqRice_UnZigZag( uint32_t u )
+{
+  return (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+}
+
+static inline int32_t IqRice_Predict( uint32_t Order, int32_t x1, int32_t x2 )
+{
+  return (Order == 0) ? 0 : (Order == 1) ? x1 : (2 * x1 - x2);
+}
+
+/* Append up to 16 bits */
+static inline void IqRice_Put( iq_rice_stream_t *s, uint32_t Value, uint32_t n )
+{
+  s->Acc = (s->Acc << n) | Value;
+  s->Bits += n;
+
+  while( s->Bits >= 8 )
+  {
+    s->Bits -= 8;
+    *s->p++ = (uint8_t)(s->Acc >> s->Bits);
+  }
+}
+
+/* Remove up to 16 bits, false at the end of the stream */
+static inline bool IqRice_Get( iq_rice_stream_t *s, uint32_t n, uint32_t *Value )
+{
+  while( s->Bits < n )
+  {
+    if( s->p == s->End )
+      return false;
+
+    s->Acc = (s->Acc << 8) | *s->p++;
+    s->Bits += 8;
+  }
+
+  s->Bits -= n;
+  *Value = (s->Acc >> s->Bits) & ((1UL << n) - 1);
+
+  return true;
+}
+
+/* Pick the predictor with the smallest residuals and the Rice parameter for
+   them, falls back to uncoded residuals when coding would not save bits */
+static uint8_t IqRice_ChooseMode( const uint32_t *Buf, uint32_t SampleCnt, uint32_t Ch )
+{
+  uint32_t Sum[IQ_RICE_ORDER_MAX + 1] = {0};
+  uint32_t Order = 0;
+  uint32_t Cost = 0;
+  uint32_t k = 0;
+  int32_t x1 = 0, x2 = 0;
+
+  for( uint32_t i = 0; i < SampleCnt; i++ )
+  {
+    int32_t x = IqRice_Channel( Buf[i], Ch );
+
+    Sum[0] += IqRice_ZigZag( x );
+    Sum[1] += IqRice_ZigZag( x - x1 );
+    Sum[2] += IqRice_ZigZag( x - 2 * x1 + x2 );
+
+    x2 = x1;
+    x1 = x;
+  }
+
+  for( uint32_t o = 1; o <= IQ_RICE_ORDER_MAX; o++ )
+    Order = (Sum[o] < Sum[Order]) ? o : Order;
+
+  /* 2^k is about the mean residual */
+  while( (k < (IQ_RICE_K_RAW - 1)) && (((uint64_t)SampleCnt << (k + 1)) <= Sum[Order]) )
+    k++;
+
+  x1 = 0;
+  x2 = 0;
+
+  for( uint32_t i = 0; i < SampleCnt; i++ )
+  {
+    int32_t x = IqRice_Channel( Buf[i], Ch );
+    uint32_t q = IqRice_ZigZag( x - IqRice_Predict( Order, x1, x2 ) ) >> k;
+
+    Cost += (q < IQ_RICE_ESCAPE) ? (q + 1 + k) : (IQ_RICE_ESCAPE + 16);
+
+    x2 = x1;
+    x1 = x;
+  }
+
+  if( Cost >= (SampleCnt * 16) )
+    return IQ_RICE_MODE( Order, IQ_RICE_K_RAW );
+
+  return IQ_RICE_MODE( Order, k );
+}
+
+static void IqRice_EncodeChannel( iq_rice_stream_t *s, const uint32_t *Buf, uint32_t SampleCnt, uint32_t Ch, uint8_t Mode )
+{
+  uint32_t Order = IQ_RICE_MODE_ORDER( Mode );
+  uint32_t k = IQ_RICE_MODE_K( Mode );
+  int32_t x1 = 0, x2 = 0;
+
+  for( uint32_t i = 0; i < SampleCnt; i++ )
+  {
+    int32_t x = IqRice_Channel( Buf[i], Ch );
+    uint32_t u = IqRice_ZigZag( x - IqRice_Predict( Order, x1, x2 ) );
+    uint32_t q = u >> k;
+
+    if( k == IQ_RICE_K_RAW )
+    {
+      IqRice_Put( s, u, 16 );
+    }
+    else if( q < IQ_RICE_ESCAPE )
+    {
+      IqRice_Put( s, ((1UL << q) - 1) << 1, q + 1 );
+      IqRice_Put( s, u & ((1UL << k) - 1), k );
+    }
+    else
+    {
+      IqRice_Put( s, (1UL << IQ_RICE_ESCAPE) - 1, IQ_RICE_ESCAPE );
+      IqRice_Put( s, u, 16 );
+    }
+
+    x2 = x1;
+    x1 = x;
+  }
+}
+
+static bool IqRice_DecodeChannel( iq_rice_stream_t *s, uint32_t *Buf, uint32_t SampleCnt, uint32_t Ch, uint8_t Mode )
+{
+  uint32_t Order = IQ_RICE_MODE_ORDER( Mode );
+  uint32_t k = IQ_RICE_MODE_K( Mode );
+  int32_t x1 = 0, x2 = 0;
+  uint32_t u, q, Bit, Low;
+
+  for( uint32_t i = 0; i < SampleCnt; i++ )
+  {
+    if( k == IQ_RICE_K_RAW )
+    {
+      if( !IqRice_Get( s, 16, &u ) )
+        return false;
+    }
+    else
+    {
+      for( q = 0; q < IQ_RICE_ESCAPE; q++ )
+      {
+        if( !IqRice_Get( s, 1, &Bit ) )
+          return false;
+
+        if( Bit == 0 )
+          break;
+      }
+
+      if( q < IQ_RICE_ESCAPE )
+      {
+        if( !IqRice_Get( s, k, &Low ) )
+          return false;
+
+        u = (q << k) | Low;
+      }
+      else if( !IqRice_Get( s, 16, &u ) )
+      {
+        return false;
+      }
+    }
+
+    int16_t x = (int16_t)(IqRice_UnZigZag( u ) + IqRice_Predict( Order, x1, x2 ));
+
+    if( Ch == 0 )
+      Buf[i] = (uint32_t)(uint16_t)x << 16;
+    else
+      Buf[i] |= (uint16_t)x;
+
+    x2 = x1;
+    x1 = x;
+  }
+
+  return true;
+}
+
+int32_t IqRice_EncodeBlock( const uint32_t *Buf, uint32_t SampleCnt, uint8_t *Out, uint32_t *Size )
+{
+  iq_rice_stream_t s = { .p = &Out[IQ_RICE_BLOCK_HDR_SIZE], .Acc = 0, .Bits = 0 };
+  uint32_t Payload;
+
+  if( (SampleCnt == 0) || (SampleCnt > IQ_RICE_BLOCK_SAMPLES) )
+    return XST_FAILURE;
+
+  Out[2] = IqRice_ChooseMode( Buf, SampleCnt, 0 );
+  Out[3] = IqRice_ChooseMode( Buf, SampleCnt, 1 );
+
+  IqRice_EncodeChannel( &s, Buf, SampleCnt, 0, Out[2] );
+  IqRice_EncodeChannel( &s, Buf, SampleCnt, 1, Out[3] );
+
+  /* Pad to a byte */
+  if( s.Bits > 0 )
+    IqRice_Put( &s, 0, 8 - s.Bits );
+
+  Payload = s.p - &Out[IQ_RICE_BLOCK_HDR_SIZE];
+
+  Out[0] = (uint8_t)Payload;
+  Out[1] = (uint8_t)(Payload >> 8);
+
+  *Size = IQ_RICE_BLOCK_HDR_SIZE + Payload;
+
+  return XST_SUCCESS;
+}
+
+int32_t IqRice_DecodeBlock( const uint8_t *In, uint32_t InSize, uint32_t *Buf, uint32_t SampleCnt, uint32_t *Size )
+{
+  iq_rice_stream_t s;
+  uint32_t Payload;
+
+  if( (SampleCnt == 0) || (SampleCnt > IQ_RICE_BLOCK_SAMPLES) || (InSize < IQ_RICE_BLOCK_HDR_SIZE) )
+    return XST_FAILURE;
+
+  Payload = In[0] | ((uint32_t)In[1] << 8);
+
+  if( (Payload > (InSize - IQ_RICE_BLOCK_HDR_SIZE)) ||
+      (IQ_RICE_MODE_ORDER( In[2] ) > IQ_RICE_ORDER_MAX) || (IQ_RICE_MODE_K( In[2] ) > IQ_RICE_K_RAW) ||
+      (IQ_RICE_MODE_ORDER( In[3] ) > IQ_RICE_ORDER_MAX) || (IQ_RICE_MODE_K( In[3] ) > IQ_RICE_K_RAW) )
+    return XST_FAILURE;
+
+  s.p = (uint8_t *)&In[IQ_RICE_BLOCK_HDR_SIZE];
+  s.End = s.p + Payload;
+  s.Acc = 0;
+  s.Bits = 0;
+
+  if( !IqRice_DecodeChannel( &s, Buf, SampleCnt, 0, In[2] ) ||
+      !IqRice_DecodeChannel( &s, Buf, SampleCnt, 1, In[3] ) )
+    return XST_FAILURE;
+
+  /* Only padding may remain */
+  if( (s.p != s.End) || (s.Bits >= 8) )
+    return XST_FAILURE;
+
+  *Size = IQ_RICE_BLOCK_HDR_SIZE + Payload;
+
+  return XST_SUCCESS;
+}
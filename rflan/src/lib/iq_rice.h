@@ -0,0 +1,120 @@
+#ifndef IQ_RICE_H_
+#define IQ_RICE_H_
+/***************************************************************************//**
+*  \ingroup    LIB
+*  \defgroup   IQ_RICE IQ Rice Coding
+*  @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       iq_rice.h
+*
+*  \details
+*
+*  This file contains the definitions for lossless compression of IQ samples.
+*  Samples are 32 bit words holding a 16 bit I and a 16 bit Q.  They are coded
+*  in blocks of IQ_RICE_BLOCK_SAMPLES, the last block of a stream may be
+*  shorter.  Every block decodes on its own.
+*
+*  \section IQ_RICE_BLOCK Block Format
+*
+*  A block starts with a four byte header: a little endian uint16 with the
+*  number of payload bytes that follow, then the I mode byte and the Q mode
+*  byte.  Bits 7:5 of a mode select the predictor and bits 4:0 the Rice
+*  parameter k.
+*
+*  Predictor 0 codes x[n], 1 codes x[n] - x[n-1] and 2 codes
+*  x[n] - 2*x[n-1] + x[n-2], with x[-1] = x[-2] = 0 at the start of every
+*  block.  Residuals wrap to 16 bits and are mapped to unsigned values as
+*  0, -1, 1, -2, 2 ... -> 0, 1, 2, 3, 4 ...
+*
+*  The payload holds the I residuals of the block followed by the Q
+*  residuals, packed MSB first and padded to a whole byte.  A residual u is
+*  u >> k one bits, a zero bit and the k low bits of u.  When u >> k is
+*  IQ_RICE_ESCAPE or more it is IQ_RICE_ESCAPE one bits followed by u in 16
+*  bits.  A k of IQ_RICE_K_RAW stores every residual in 16 bits, which bounds
+*  a block to IQ_RICE_BLOCK_MAX_SIZE bytes.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+
+#define IQ_RICE_BLOCK_SAMPLES       (1024)    ///< Samples per block
+#define IQ_RICE_BLOCK_HDR_SIZE      (4)       ///< Bytes of block header
+#define IQ_RICE_BLOCK_MAX_SIZE      (IQ_RICE_BLOCK_HDR_SIZE + IQ_RICE_BLOCK_SAMPLES * sizeof(uint32_t)) ///< Largest coded block
+#define IQ_RICE_ESCAPE              (16)      ///< Quotient that escapes to a 16 bit residual
+#define IQ_RICE_K_RAW               (16)      ///< Rice parameter of uncoded residuals
+#define IQ_RICE_ORDER_MAX           (2)       ///< Highest predictor order
+
+/*******************************************************************************
+*
+* \details
+*
+* This function codes a block of IQ samples.  The predictor and Rice parameter
+* are chosen separately for I and Q.
+*
+* \param[in]  Buf is a buffer containing 32bit IQ samples
+*
+* \param[in]  SampleCnt is the number of samples in Buf, 1 to
+*             IQ_RICE_BLOCK_SAMPLES
+*
+* \param[out] Out receives the block, it must hold IQ_RICE_BLOCK_MAX_SIZE bytes
+*
+* \param[out] Size is the number of bytes written to Out
+*
+* \return     XST_SUCCESS or XST_FAILURE if SampleCnt is out of range
+*
+*******************************************************************************/
+int32_t IqRice_EncodeBlock( const uint32_t *Buf, uint32_t SampleCnt, uint8_t *Out, uint32_t *Size );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function decodes a block of IQ samples.
+*
+* \param[in]  In is the coded block
+*
+* \param[in]  InSize is the number of bytes available at In
+*
+* \param[out] Buf receives SampleCnt 32bit IQ samples
+*
+* \param[in]  SampleCnt is the number of samples coded in the block
+*
+* \param[out] Size is the number of bytes of In used by the block
+*
+* \return     XST_SUCCESS or XST_FAILURE if the block is incomplete or corrupt
+*
+*******************************************************************************/
+int32_t IqRice_DecodeBlock( const uint8_t *In, uint32_t InSize, uint32_t *Buf, uint32_t SampleCnt, uint32_t *Size );
+
+#endif /* IQ_RICE_H_ */
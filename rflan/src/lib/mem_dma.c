@@ -0,0 +1,446 @@
+/***************************************************************************//**
+*  \addtogroup MEM_DMA
+*   @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       mem_dma.c
+*
+*  \details    This file contains the memory to memory DMA service.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "mem_dma.h"
+#include "parameters.h"
+#include "iq_buf.h"
+#include "timestamp.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "xzdma.h"
+#include "xscugic.h"
+#include "xil_cache.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexr5.h"
+#include "xstatus.h"
+
+/**
+**  Memory DMA Operation
+*/
+typedef enum
+{
+  MemDmaOp_Copy,
+  MemDmaOp_Fill,
+  MemDmaOp_Copy2d,
+} mem_dma_op_t;
+
+/**
+**  Memory DMA Request
+*/
+typedef struct
+{
+  mem_dma_op_t          Op;             ///< Operation
+  UINTPTR               Dst;            ///< Destination
+  UINTPTR               Src;            ///< Source
+  uint32_t              Size;           ///< Bytes, or bytes per row of a strided copy
+  uint32_t              Pattern;        ///< Fill pattern
+  uint32_t              DstStride;      ///< Destination row stride
+  uint32_t              SrcStride;      ///< Source row stride
+  uint32_t              RowCnt;         ///< Rows of a strided copy
+  mem_dma_callback_t    Callback;       ///< Completion callback
+  void                 *CallbackRef;    ///< Completion callback reference
+} mem_dma_req_t;
+
+extern XScuGic          xInterruptController;
+
+static XZDma            MemDmaInst;
+static XZDma_LiDscr     MemDmaBd[2 * MEM_DMA_ROW_MAX] __attribute__((aligned(64)));  ///< Source and destination descriptors of a strided copy
+static XZDma_Transfer   MemDmaRow[MEM_DMA_ROW_MAX];
+static mem_dma_req_t    MemDmaQueue[MEM_DMA_QUEUE_SIZE];
+static volatile uint32_t MemDmaHead;    ///< Request in progress
+static volatile uint32_t MemDmaTail;    ///< Next free request
+static volatile bool    MemDmaBusy;     ///< Request at MemDmaHead is running
+static volatile int32_t MemDmaSyncStatus;
+static bool             MemDmaSubmitFailed; ///< Request refused by the channel in the submit path
+static SemaphoreHandle_t MemDmaSyncSem; ///< Given when a blocking request completes
+static SemaphoreHandle_t MemDmaSyncMutex; ///< Serializes blocking requests
+static uint64_t         MemDmaStartTime;
+static mem_dma_stats_t  MemDmaStats;
+static bool             MemDmaReady;
+
+static inline uint32_t MemDma_Lock( void )
+{
+  uint32_t Cpsr = mfcpsr();
+
+  mtcpsr( Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE );
+
+  return Cpsr;
+}
+
+static inline void MemDma_Unlock( uint32_t Cpsr )
+{
+  mtcpsr( Cpsr );
+}
+
+/* Clean and discard the lines of a request so neither the DMA reads stale
+   data nor an eviction overwrites what it writes */
+static void MemDma_CacheFlush( UINTPTR Addr, uint32_t Span )
+{
+  if( Span >= MEM_DMA_CACHE_ALL_SIZE )
+    Xil_DCacheFlush( );
+  else
+    IqBuf_Flush( (const void *)Addr, Span );
+}
+
+static int32_t MemDma_Start( void )
+{
+  mem_dma_req_t *Req = &MemDmaQueue[ MemDmaHead % MEM_DMA_QUEUE_SIZE ];
+  XZDma_Transfer Xfer = { 0 };
+  uint32_t Pattern[4];
+  int32_t Status = XST_FAILURE;
+
+  MemDmaStartTime = Timestamp_Get();
+
+  switch( Req->Op )
+  {
+    case MemDmaOp_Copy:
+      Xfer.SrcAddr = Req->Src;
+      Xfer.DstAddr = Req->Dst;
+      Xfer.Size    = Req->Size;
+
+      if( XZDma_SetMode( &MemDmaInst, FALSE, XZDMA_NORMAL_MODE ) == XST_SUCCESS )
+        Status = XZDma_Start( &MemDmaInst, &Xfer, 1 );
+      break;
+
+    case MemDmaOp_Fill:
+      Pattern[0] = Pattern[1] = Pattern[2] = Pattern[3] = Req->Pattern;
+      Xfer.DstAddr = Req->Dst;
+      Xfer.Size    = Req->Size;
+
+      if( XZDma_SetMode( &MemDmaInst, FALSE, XZDMA_WRONLY_MODE ) == XST_SUCCESS )
+      {
+        XZDma_WOData( &MemDmaInst, Pattern );
+        Status = XZDma_Start( &MemDmaInst, &Xfer, 1 );
+      }
+      break;
+
+    case MemDmaOp_Copy2d:
+      for( uint32_t i = 0; i < Req->RowCnt; i++ )
+      {
+        MemDmaRow[i] = (XZDma_Transfer){ 0 };
+        MemDmaRow[i].SrcAddr = Req->Src + i * Req->SrcStride;
+        MemDmaRow[i].DstAddr = Req->Dst + i * Req->DstStride;
+        MemDmaRow[i].Size    = Req->Size;
+      }
+
+      if( XZDma_SetMode( &MemDmaInst, TRUE, XZDMA_NORMAL_MODE ) == XST_SUCCESS )
+        Status = XZDma_Start( &MemDmaInst, MemDmaRow, Req->RowCnt );
+      break;
+  }
+
+  return Status;
+}
+
+/* Start the next request, failing any the channel refuses.  Must be called
+   from the ISR or with interrupts masked.  The queue is empty whenever the
+   channel is idle outside the ISR, so a request refused in the submit path is
+   the one being submitted.  It is not signalled, MemDma_Submit returns the
+   failure instead of calling back from task context. */
+static void MemDma_Run( bool FromIsr )
+{
+  while( !MemDmaBusy && (MemDmaHead != MemDmaTail) )
+  {
+    if( MemDma_Start( ) == XST_SUCCESS )
+    {
+      MemDmaBusy = true;
+      break;
+    }
+
+    mem_dma_req_t Req = MemDmaQueue[ MemDmaHead % MEM_DMA_QUEUE_SIZE ];
+
+    MemDmaStats.ErrorCnt++;
+    MemDmaHead++;
+
+    if( !FromIsr )
+      MemDmaSubmitFailed = true;
+    else if( Req.Callback != NULL )
+      Req.Callback( XST_FAILURE, Req.CallbackRef );
+  }
+}
+
+static void MemDma_Complete( int32_t Status )
+{
+  mem_dma_req_t Req = MemDmaQueue[ MemDmaHead % MEM_DMA_QUEUE_SIZE ];
+
+  MemDmaStats.BusyTime += Timestamp_Get() - MemDmaStartTime;
+  MemDmaBusy = false;
+
+  if( Status == XST_SUCCESS )
+  {
+    if( Req.Op == MemDmaOp_Copy )
+      MemDmaStats.CopyCnt++;
+    else if( Req.Op == MemDmaOp_Fill )
+      MemDmaStats.FillCnt++;
+    else
+      MemDmaStats.Copy2dCnt++;
+
+    MemDmaStats.ByteCnt += (uint64_t)Req.Size * ((Req.Op == MemDmaOp_Copy2d) ? Req.RowCnt : 1);
+  }
+  else
+  {
+    MemDmaStats.ErrorCnt++;
+  }
+
+  MemDmaHead++;
+
+  if( Req.Callback != NULL )
+    Req.Callback( Status, Req.CallbackRef );
+
+  MemDma_Run( true );
+}
+
+static void MemDma_DoneHandler( void *CallBackRef )
+{
+  if( MemDmaBusy )
+    MemDma_Complete( XST_SUCCESS );
+}
+
+static void MemDma_ErrorHandler( void *CallBackRef, u32 Mask )
+{
+  if( MemDmaBusy )
+    MemDma_Complete( XST_FAILURE );
+}
+
+static void MemDma_SyncCallback( int32_t Status, void *CallbackRef )
+{
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+  MemDmaSyncStatus = Status;
+
+  xSemaphoreGiveFromISR( MemDmaSyncSem, &xHigherPriorityTaskWoken );
+
+  portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+static int32_t MemDma_Submit( mem_dma_req_t *Req, UINTPTR SrcAddr, uint32_t SrcSpan, UINTPTR DstAddr, uint32_t DstSpan )
+{
+  bool Sync = (Req->Callback == NULL);
+  bool Failed;
+  uint32_t Cpsr;
+  uint32_t Cnt;
+
+  if( !MemDmaReady )
+    return XST_FAILURE;
+
+  if( Sync )
+  {
+    xSemaphoreTake( MemDmaSyncMutex, portMAX_DELAY );
+    Req->Callback = MemDma_SyncCallback;
+  }
+
+  if( SrcSpan > 0 )
+    MemDma_CacheFlush( SrcAddr, SrcSpan );
+
+  /* The whole cache was flushed with the source */
+  if( (SrcSpan < MEM_DMA_CACHE_ALL_SIZE) || (DstSpan >= MEM_DMA_CACHE_ALL_SIZE) )
+    MemDma_CacheFlush( DstAddr, DstSpan );
+
+  Cpsr = MemDma_Lock();
+
+  if( (MemDmaTail - MemDmaHead) >= MEM_DMA_QUEUE_SIZE )
+  {
+    MemDmaStats.QueueFullCnt++;
+    MemDma_Unlock( Cpsr );
+
+    if( Sync )
+      xSemaphoreGive( MemDmaSyncMutex );
+
+    return XST_FAILURE;
+  }
+
+  MemDmaQueue[ MemDmaTail % MEM_DMA_QUEUE_SIZE ] = *Req;
+  MemDmaTail++;
+
+  Cnt = MemDmaTail - MemDmaHead;
+  if( Cnt > MemDmaStats.QueueHighWater )
+    MemDmaStats.QueueHighWater = Cnt;
+
+  MemDmaSubmitFailed = false;
+
+  MemDma_Run( false );
+
+  Failed = MemDmaSubmitFailed;
+
+  MemDma_Unlock( Cpsr );
+
+  if( Failed )
+  {
+    if( Sync )
+      xSemaphoreGive( MemDmaSyncMutex );
+
+    return XST_FAILURE;
+  }
+
+  if( !Sync )
+    return XST_SUCCESS;
+
+  xSemaphoreTake( MemDmaSyncSem, portMAX_DELAY );
+
+  int32_t Status = MemDmaSyncStatus;
+
+  xSemaphoreGive( MemDmaSyncMutex );
+
+  return Status;
+}
+
+int32_t MemDma_Copy( void *Dst, const void *Src, uint32_t Size, mem_dma_callback_t Callback, void *CallbackRef )
+{
+  if( (Dst == NULL) || (Src == NULL) || (Size == 0) || (Size > MEM_DMA_SIZE_MAX) )
+    return XST_FAILURE;
+
+  mem_dma_req_t Req = {
+      .Op           = MemDmaOp_Copy,
+      .Dst          = (UINTPTR)Dst,
+      .Src          = (UINTPTR)Src,
+      .Size         = Size,
+      .Callback     = Callback,
+      .CallbackRef  = CallbackRef
+  };
+
+  return MemDma_Submit( &Req, Req.Src, Size, Req.Dst, Size );
+}
+
+int32_t MemDma_Fill( void *Dst, uint32_t Pattern, uint32_t Size, mem_dma_callback_t Callback, void *CallbackRef )
+{
+  if( (Dst == NULL) || ((UINTPTR)Dst % sizeof(uint32_t)) || (Size == 0) || (Size % sizeof(uint32_t)) || (Size > MEM_DMA_SIZE_MAX) )
+    return XST_FAILURE;
+
+  mem_dma_req_t Req = {
+      .Op           = MemDmaOp_Fill,
+      .Dst          = (UINTPTR)Dst,
+      .Size         = Size,
+      .Pattern      = Pattern,
+      .Callback     = Callback,
+      .CallbackRef  = CallbackRef
+  };
+
+  return MemDma_Submit( &Req, 0, 0, Req.Dst, Size );
+}
+
+int32_t MemDma_Copy2d( void *Dst, uint32_t DstStride, const void *Src, uint32_t SrcStride,
+                       uint32_t RowSize, uint32_t RowCnt, mem_dma_callback_t Callback, void *CallbackRef )
+{
+  if( (Dst == NULL) || (Src == NULL) || (RowSize == 0) || (RowCnt == 0) || (RowCnt > MEM_DMA_ROW_MAX) ||
+      (DstStride < RowSize) || (SrcStride < RowSize) || (((uint64_t)RowSize * RowCnt) > MEM_DMA_SIZE_MAX) )
+    return XST_FAILURE;
+
+  mem_dma_req_t Req = {
+      .Op           = MemDmaOp_Copy2d,
+      .Dst          = (UINTPTR)Dst,
+      .Src          = (UINTPTR)Src,
+      .Size         = RowSize,
+      .DstStride    = DstStride,
+      .SrcStride    = SrcStride,
+      .RowCnt       = RowCnt,
+      .Callback     = Callback,
+      .CallbackRef  = CallbackRef
+  };
+
+  return MemDma_Submit( &Req, Req.Src, (RowCnt - 1) * SrcStride + RowSize, Req.Dst, (RowCnt - 1) * DstStride + RowSize );
+}
+
+int32_t MemDma_GetStats( mem_dma_stats_t *Stats )
+{
+  if( Stats == NULL )
+    return XST_FAILURE;
+
+  uint32_t Cpsr = MemDma_Lock();
+
+  *Stats = MemDmaStats;
+
+  MemDma_Unlock( Cpsr );
+
+  return XST_SUCCESS;
+}
+
+int32_t MemDma_Initialize( void )
+{
+  XZDma_Config *Config;
+  XZDma_DataConfig DataCfg;
+
+  if((Config = XZDma_LookupConfig( MEM_DMA_DEVICE_ID )) == NULL)
+    return XST_FAILURE;
+
+  if(XZDma_CfgInitialize( &MemDmaInst, Config, Config->BaseAddress ) != XST_SUCCESS)
+    return XST_FAILURE;
+
+  /* Longest bursts and as many outstanding reads as the channel allows */
+  XZDma_GetChDataConfig( &MemDmaInst, &DataCfg );
+  DataCfg.OverFetch     = 0;
+  DataCfg.SrcIssue      = 0x1F;
+  DataCfg.SrcBurstType  = XZDMA_INCR_BURST;
+  DataCfg.SrcBurstLen   = 0xF;
+  DataCfg.DstBurstType  = XZDMA_INCR_BURST;
+  DataCfg.DstBurstLen   = 0xF;
+  XZDma_SetChDataConfig( &MemDmaInst, &DataCfg );
+
+  /* Descriptor memory for strided copies */
+  if(XZDma_SetMode( &MemDmaInst, TRUE, XZDMA_NORMAL_MODE ) != XST_SUCCESS)
+    return XST_FAILURE;
+
+  if(XZDma_CreateBDList( &MemDmaInst, XZDMA_LINEAR, (UINTPTR)MemDmaBd, sizeof(MemDmaBd) ) < MEM_DMA_ROW_MAX)
+    return XST_FAILURE;
+
+  if((MemDmaSyncSem = xSemaphoreCreateBinary()) == NULL)
+    return XST_FAILURE;
+
+  if((MemDmaSyncMutex = xSemaphoreCreateMutex()) == NULL)
+    return XST_FAILURE;
+
+  XZDma_SetCallBack( &MemDmaInst, XZDMA_HANDLER_DONE, (void *)MemDma_DoneHandler, NULL );
+  XZDma_SetCallBack( &MemDmaInst, XZDMA_HANDLER_ERROR, (void *)MemDma_ErrorHandler, NULL );
+
+  if(XScuGic_Connect( &xInterruptController, MEM_DMA_INTR_ID, (XInterruptHandler)XZDma_IntrHandler, &MemDmaInst ) != XST_SUCCESS)
+    return XST_FAILURE;
+
+  XZDma_EnableIntr( &MemDmaInst, XZDMA_IXR_ALL_INTR_MASK );
+  XScuGic_Enable( &xInterruptController, MEM_DMA_INTR_ID );
+
+  MemDmaHead = 0;
+  MemDmaTail = 0;
+  MemDmaBusy = false;
+  MemDmaReady = true;
+
+  return XST_SUCCESS;
+}
@@ -0,0 +1,181 @@
+#ifndef MEM_DMA_H_
+#define MEM_DMA_H_
+/***************************************************************************//**
+*  \ingroup    LIB
+*  \defgroup   MEM_DMA Memory DMA
+*  @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       mem_dma.h
+*
+*  \details
+*
+*  This file contains the definitions for the memory to memory DMA service.
+*  Copies, fills and strided copies of sample buffers are queued to a PS GDMA
+*  channel so the processor is free while multi megabyte buffers are moved.
+*  Requests complete in order.  The callback of a request is called from the
+*  DMA interrupt, a request without a callback blocks the calling task until
+*  it completes.  A request the channel refuses as it is submitted fails the
+*  call and is not called back.  The processor must not access the buffers of
+*  a request until it completes, cache maintenance is done by the service.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+
+#define MEM_DMA_QUEUE_SIZE        (16)          ///< Requests that can be outstanding
+#define MEM_DMA_ROW_MAX           (256)         ///< Rows of a strided copy
+#define MEM_DMA_SIZE_MAX          (0x40000000)  ///< Bytes moved by one request
+#define MEM_DMA_CACHE_ALL_SIZE    (0x10000)     ///< Requests of at least this many bytes clean the whole data cache
+
+/**
+**  Memory DMA Callback
+**
+**  Called from the DMA interrupt with XST_SUCCESS or XST_FAILURE.
+*/
+typedef void (*mem_dma_callback_t)( int32_t Status, void *CallbackRef );
+
+/**
+**  Memory DMA Statistics
+*/
+typedef struct
+{
+  uint32_t          CopyCnt;          ///< Copies completed
+  uint32_t          FillCnt;          ///< Fills completed
+  uint32_t          Copy2dCnt;        ///< Strided copies completed
+  uint32_t          ErrorCnt;         ///< Requests that completed with an error
+  uint32_t          QueueFullCnt;     ///< Requests rejected because the queue was full
+  uint32_t          QueueHighWater;   ///< Maximum number of outstanding requests
+  uint64_t          ByteCnt;          ///< Bytes written by completed requests
+  uint64_t          BusyTime;         ///< Time the channel was busy in TIMESTAMP_FREQ_HZ ticks
+} mem_dma_stats_t;
+
+/*******************************************************************************
+*
+* \details
+*
+* This function copies a buffer.
+*
+* \param[in]  Dst is the destination
+*
+* \param[in]  Src is the source
+*
+* \param[in]  Size is the number of bytes, at most MEM_DMA_SIZE_MAX
+*
+* \param[in]  Callback is called on completion, NULL = block until complete
+*
+* \param[in]  CallbackRef is passed to Callback
+*
+* \return     Status
+*
+*******************************************************************************/
+int32_t MemDma_Copy( void *Dst, const void *Src, uint32_t Size, mem_dma_callback_t Callback, void *CallbackRef );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function fills a buffer with a 32-bit pattern, a pattern of zero clears
+* the buffer.
+*
+* \param[in]  Dst is the destination, 4 byte aligned
+*
+* \param[in]  Pattern is written to every word
+*
+* \param[in]  Size is the number of bytes, a multiple of 4
+*
+* \param[in]  Callback is called on completion, NULL = block until complete
+*
+* \param[in]  CallbackRef is passed to Callback
+*
+* \return     Status
+*
+*******************************************************************************/
+int32_t MemDma_Fill( void *Dst, uint32_t Pattern, uint32_t Size, mem_dma_callback_t Callback, void *CallbackRef );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function copies RowCnt rows of RowSize bytes, each row starting
+* SrcStride bytes after the previous one in the source and DstStride bytes
+* after the previous one in the destination.  It repacks the rows of a
+* strided stream into a contiguous buffer or the reverse.
+*
+* \param[in]  Dst is the first destination row
+*
+* \param[in]  DstStride is the distance between destination rows
+*
+* \param[in]  Src is the first source row
+*
+* \param[in]  SrcStride is the distance between source rows
+*
+* \param[in]  RowSize is the number of bytes per row
+*
+* \param[in]  RowCnt is the number of rows, at most MEM_DMA_ROW_MAX
+*
+* \param[in]  Callback is called on completion, NULL = block until complete
+*
+* \param[in]  CallbackRef is passed to Callback
+*
+* \return     Status
+*
+*******************************************************************************/
+int32_t MemDma_Copy2d( void *Dst, uint32_t DstStride, const void *Src, uint32_t SrcStride,
+                       uint32_t RowSize, uint32_t RowCnt, mem_dma_callback_t Callback, void *CallbackRef );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function returns the service statistics.
+*
+* \param[out] Stats is the returned statistics
+*
+* \return     Status
+*
+*******************************************************************************/
+int32_t MemDma_GetStats( mem_dma_stats_t *Stats );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function initializes the GDMA channel and connects its interrupt.
+*
+* \return     Status
+*
+*******************************************************************************/
+int32_t MemDma_Initialize( void );
+
+#endif /* MEM_DMA_H_ */
@@ -0,0 +1,250 @@
+/***************************************************************************//**
+*  \addtogroup MEM_POOL
+*   @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       mem_pool.c
+*
+*  \details    This file contains the fixed block memory pools.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "mem_pool.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexr5.h"
+#include "xstatus.h"
+
+/**
+**  Memory Pool Free Block
+**
+**  Free blocks are linked through their first word.
+*/
+typedef struct mem_pool_free_s
+{
+  struct mem_pool_free_s *Next;
+} mem_pool_free_t;
+
+/**
+**  Memory Pool Size Class
+*/
+typedef struct
+{
+  uint8_t              *Mem;            ///< Block storage
+  void                **Owner;          ///< Allocating caller of each block, NULL when free
+  mem_pool_free_t      *FreeList;       ///< Blocks that have been freed
+  uint32_t              Fresh;          ///< Blocks never allocated start at this index
+  mem_pool_stats_t      Stats;          ///< Statistics
+} mem_pool_class_t;
+
+static uint8_t  MemPoolSmallMem[MEM_POOL_SMALL_CNT * MEM_POOL_SMALL_SIZE] __attribute__((aligned(8)));
+static uint8_t  MemPoolMediumMem[MEM_POOL_MEDIUM_CNT * MEM_POOL_MEDIUM_SIZE] __attribute__((aligned(8)));
+static uint8_t  MemPoolLargeMem[MEM_POOL_LARGE_CNT * MEM_POOL_LARGE_SIZE] __attribute__((aligned(8)));
+static void    *MemPoolSmallOwner[MEM_POOL_SMALL_CNT];
+static void    *MemPoolMediumOwner[MEM_POOL_MEDIUM_CNT];
+static void    *MemPoolLargeOwner[MEM_POOL_LARGE_CNT];
+
+/* Classes are statically initialized so the DMA driver can allocate before
+   the application task runs.  Blocks are handed out in index order until
+   every block has been used once, then from the free list. */
+static mem_pool_class_t MemPoolClass[MEM_POOL_CLASS_CNT] =
+{
+  { .Mem = MemPoolSmallMem,  .Owner = MemPoolSmallOwner,  .Stats = { .BlockSize = MEM_POOL_SMALL_SIZE,  .BlockCnt = MEM_POOL_SMALL_CNT  } },
+  { .Mem = MemPoolMediumMem, .Owner = MemPoolMediumOwner, .Stats = { .BlockSize = MEM_POOL_MEDIUM_SIZE, .BlockCnt = MEM_POOL_MEDIUM_CNT } },
+  { .Mem = MemPoolLargeMem,  .Owner = MemPoolLargeOwner,  .Stats = { .BlockSize = MEM_POOL_LARGE_SIZE,  .BlockCnt = MEM_POOL_LARGE_CNT  } },
+};
+
+static inline uint32_t MemPool_Lock( void )
+{
+  uint32_t Cpsr = mfcpsr();
+
+  mtcpsr( Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE );
+
+  return Cpsr;
+}
+
+static inline void MemPool_Unlock( uint32_t Cpsr )
+{
+  mtcpsr( Cpsr );
+}
+
+static mem_pool_class_t *MemPool_FindClass( const void *Buf )
+{
+  for( int i = 0; i < MEM_POOL_CLASS_CNT; i++ )
+  {
+    mem_pool_class_t *Class = &MemPoolClass[i];
+
+    if(((const uint8_t *)Buf >= Class->Mem) &&
+       ((const uint8_t *)Buf < Class->Mem + Class->Stats.BlockCnt * Class->Stats.BlockSize))
+      return Class;
+  }
+
+  return NULL;
+}
+
+void *MemPool_Alloc( uint32_t Size )
+{
+  mem_pool_class_t *Class = NULL;
+  void *Owner = __builtin_return_address(0);
+  uint8_t *Buf = NULL;
+  uint32_t Idx;
+
+  for( int i = 0; i < MEM_POOL_CLASS_CNT; i++ )
+  {
+    if( Size <= MemPoolClass[i].Stats.BlockSize )
+    {
+      Class = &MemPoolClass[i];
+      break;
+    }
+  }
+
+  if( Class == NULL )
+    return NULL;
+
+  uint32_t Cpsr = MemPool_Lock();
+
+  if( Class->FreeList != NULL )
+  {
+    Buf = (uint8_t *)Class->FreeList;
+    Class->FreeList = Class->FreeList->Next;
+  }
+  else if( Class->Fresh < Class->Stats.BlockCnt )
+  {
+    Buf = &Class->Mem[Class->Fresh++ * Class->Stats.BlockSize];
+  }
+
+  if( Buf != NULL )
+  {
+    Idx = (Buf - Class->Mem) / Class->Stats.BlockSize;
+    Class->Owner[Idx] = Owner;
+
+    Class->Stats.AllocCnt++;
+    if( ++Class->Stats.Used > Class->Stats.HighWater )
+      Class->Stats.HighWater = Class->Stats.Used;
+  }
+  else
+  {
+    Class->Stats.FailCnt++;
+  }
+
+  MemPool_Unlock( Cpsr );
+
+  return Buf;
+}
+
+void MemPool_Free( void *Buf )
+{
+  mem_pool_class_t *Class;
+  uint32_t Offset;
+  uint32_t Idx;
+
+  if( Buf == NULL )
+    return;
+
+  if((Class = MemPool_FindClass( Buf )) == NULL)
+  {
+    /* Not one of ours, nothing to return it to */
+    uint32_t Cpsr = MemPool_Lock();
+    MemPoolClass[0].Stats.BadFreeCnt++;
+    MemPool_Unlock( Cpsr );
+    return;
+  }
+
+  Offset = (uint8_t *)Buf - Class->Mem;
+  Idx = Offset / Class->Stats.BlockSize;
+
+  uint32_t Cpsr = MemPool_Lock();
+
+  if(((Offset % Class->Stats.BlockSize) != 0) || (Class->Owner[Idx] == NULL))
+  {
+    Class->Stats.BadFreeCnt++;
+  }
+  else
+  {
+    Class->Owner[Idx] = NULL;
+    ((mem_pool_free_t *)Buf)->Next = Class->FreeList;
+    Class->FreeList = (mem_pool_free_t *)Buf;
+
+    Class->Stats.Used--;
+    Class->Stats.FreeCnt++;
+  }
+
+  MemPool_Unlock( Cpsr );
+}
+
+int32_t MemPool_GetStats( uint32_t Class, mem_pool_stats_t *Stats )
+{
+  if((Stats == NULL) || (Class >= MEM_POOL_CLASS_CNT))
+    return XST_FAILURE;
+
+  uint32_t Cpsr = MemPool_Lock();
+
+  *Stats = MemPoolClass[Class].Stats;
+
+  MemPool_Unlock( Cpsr );
+
+  return XST_SUCCESS;
+}
+
+uint32_t MemPool_GetOutstanding( mem_pool_block_t *List, uint32_t Cnt )
+{
+  uint32_t Total = 0;
+
+  for( int i = 0; i < MEM_POOL_CLASS_CNT; i++ )
+  {
+    mem_pool_class_t *Class = &MemPoolClass[i];
+
+    for( uint32_t Idx = 0; Idx < Class->Fresh; Idx++ )
+    {
+      uint32_t Cpsr = MemPool_Lock();
+      void *Owner = Class->Owner[Idx];
+      MemPool_Unlock( Cpsr );
+
+      if( Owner == NULL )
+        continue;
+
+      if((List != NULL) && (Total < Cnt))
+      {
+        List[Total].Buf       = &Class->Mem[Idx * Class->Stats.BlockSize];
+        List[Total].Owner     = Owner;
+        List[Total].BlockSize = Class->Stats.BlockSize;
+      }
+
+      Total++;
+    }
+  }
+
+  return Total;
+}
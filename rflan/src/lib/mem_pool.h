@@ -0,0 +1,145 @@
+#ifndef MEM_POOL_H_
+#define MEM_POOL_H_
+/***************************************************************************//**
+*  \ingroup    LIB
+*  \defgroup   MEM_POOL Memory Pool
+*  @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       mem_pool.h
+*
+*  \details
+*
+*  This file contains the definitions for the fixed block memory pools.  Small
+*  objects that are allocated and freed while the radio runs (filenames, DMA
+*  instances) come from statically reserved blocks instead of the heap, so
+*  allocation takes constant time and the heap does not fragment.  A request
+*  is served by the smallest size class that fits it.  The pools may be used
+*  before they are initialized and from interrupts.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+
+#define MEM_POOL_CLASS_CNT        (3)           ///< Number of size classes
+#define MEM_POOL_SMALL_SIZE       (64)          ///< Bytes per small block
+#define MEM_POOL_SMALL_CNT        (32)          ///< Number of small blocks
+#define MEM_POOL_MEDIUM_SIZE      (256)         ///< Bytes per medium block, holds a filename
+#define MEM_POOL_MEDIUM_CNT       (16)          ///< Number of medium blocks
+#define MEM_POOL_LARGE_SIZE       (1536)        ///< Bytes per large block, holds an axi_dmac_t
+#define MEM_POOL_LARGE_CNT        (8)           ///< Number of large blocks
+
+/**
+**  Memory Pool Statistics
+*/
+typedef struct
+{
+  uint32_t          BlockSize;        ///< Bytes per block
+  uint32_t          BlockCnt;         ///< Number of blocks
+  uint32_t          Used;             ///< Blocks currently allocated
+  uint32_t          HighWater;        ///< Maximum value of Used
+  uint32_t          AllocCnt;         ///< Number of successful allocations
+  uint32_t          FreeCnt;          ///< Number of blocks freed
+  uint32_t          FailCnt;          ///< Number of allocations that found the class empty
+  uint32_t          BadFreeCnt;       ///< Number of frees of a block that was not allocated
+} mem_pool_stats_t;
+
+/**
+**  Memory Pool Outstanding Block
+*/
+typedef struct
+{
+  void             *Buf;              ///< Block
+  void             *Owner;            ///< Return address of the caller that allocated it
+  uint32_t          BlockSize;        ///< Bytes per block
+} mem_pool_block_t;
+
+/*******************************************************************************
+*
+* \details
+*
+* This function allocates a block from the smallest size class that holds
+* Size bytes.  Blocks are aligned to 8 bytes.  The block is not cleared.
+*
+* \param[in]  Size is the number of bytes requested
+*
+* \return     Pointer to block or NULL if the size class is exhausted
+*
+*******************************************************************************/
+void *MemPool_Alloc( uint32_t Size );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function returns a block to its pool.  NULL is ignored.  Pointers that
+* are not an allocated block are counted in BadFreeCnt and otherwise ignored.
+*
+* \param[in]  Buf is a block returned by MemPool_Alloc
+*
+*******************************************************************************/
+void MemPool_Free( void *Buf );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function gets the statistics of a size class.
+*
+* \param[in]  Class is the size class, 0 to MEM_POOL_CLASS_CNT - 1
+*
+* \param[out] Stats is the statistics of the class
+*
+* \return     XST_SUCCESS or XST_FAILURE
+*
+*******************************************************************************/
+int32_t MemPool_GetStats( uint32_t Class, mem_pool_stats_t *Stats );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function lists the blocks that are currently allocated and the code
+* that allocated them.  A block that stays on this list while the radio is
+* idle is a leak.
+*
+* \param[out] List receives up to Cnt blocks
+*
+* \param[in]  Cnt is the number of entries in List
+*
+* \return     Number of allocated blocks, which may be more than Cnt
+*
+*******************************************************************************/
+uint32_t MemPool_GetOutstanding( mem_pool_block_t *List, uint32_t Cnt );
+
+#endif /* MEM_POOL_H_ */
@@ -0,0 +1,109 @@
+/***************************************************************************//**
+*  \addtogroup TIMESTAMP
+*   @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       timestamp.c
+*
+*  \details    This file contains the RFLAN timestamp implementation.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+#include "timestamp.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexr5.h"
+#include "xstatus.h"
+
+#define TIMESTAMP_PMCR_ENABLE       (0x01)        ///< PMCR enable all counters
+#define TIMESTAMP_PMCR_CYCLE_RESET  (0x04)        ///< PMCR reset cycle counter
+#define TIMESTAMP_PMCNTEN_CYCLE     (0x80000000)  ///< PMCNTENSET cycle counter enable
+
+static volatile uint32_t TimestampHigh;     ///< Upper 32 bits of timestamp
+static volatile uint32_t TimestampLast;     ///< Last cycle counter value read
+
+uint64_t Timestamp_Get( void )
+{
+  uint32_t Cpsr = mfcpsr();
+
+  /* Mask interrupts so the extension is updated atomically */
+  mtcpsr( Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE );
+
+  uint32_t Low = mfcp( XREG_CP15_PERF_CYCLE_COUNTER );
+
+  /* Counter wrapped since last read */
+  if( Low < TimestampLast )
+    TimestampHigh++;
+
+  TimestampLast = Low;
+
+  uint64_t Timestamp = ((uint64_t)TimestampHigh << 32) | Low;
+
+  mtcpsr( Cpsr );
+
+  return Timestamp;
+}
+
+/* Scale without overflowing the intermediate product for large tick counts */
+static uint64_t Timestamp_Scale( uint64_t Ticks, uint32_t Rate )
+{
+  uint64_t Sec = Ticks / TIMESTAMP_FREQ_HZ;
+  uint64_t Rem = Ticks % TIMESTAMP_FREQ_HZ;
+
+  return (Sec * Rate) + ((Rem * Rate) / TIMESTAMP_FREQ_HZ);
+}
+
+uint64_t Timestamp_ToUs( uint64_t Ticks )
+{
+  return Timestamp_Scale( Ticks, 1000000 );
+}
+
+uint64_t Timestamp_ToSamples( uint64_t Ticks, uint32_t SampleRate )
+{
+  return Timestamp_Scale( Ticks, SampleRate );
+}
+
+int32_t Timestamp_Initialize( void )
+{
+  uint32_t Pmcr = mfcp( XREG_CP15_PERF_MONITOR_CTRL );
+
+  /* Reset and Enable Cycle Counter */
+  mtcp( XREG_CP15_PERF_MONITOR_CTRL, Pmcr | TIMESTAMP_PMCR_ENABLE | TIMESTAMP_PMCR_CYCLE_RESET );
+  mtcp( XREG_CP15_COUNT_ENABLE_SET, TIMESTAMP_PMCNTEN_CYCLE );
+  isb();
+
+  TimestampHigh = 0;
+  TimestampLast = 0;
+
+  return XST_SUCCESS;
+}
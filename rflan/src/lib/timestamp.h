@@ -0,0 +1,107 @@
+#ifndef SRC_TIMESTAMP_H_
+#define SRC_TIMESTAMP_H_
+/***************************************************************************//**
+*  \ingroup    APP
+*  \defgroup   TIMESTAMP RFLAN Timestamp
+*  @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       timestamp.h
+*
+*  \details
+*
+*  This file contains a free running 64-bit timestamp derived from the R5 PMU
+*  cycle counter.  The 32-bit hardware counter is extended in software so
+*  Timestamp_Get must be called at least once per counter wrap (~8 seconds at
+*  the R5 clock rate).  The application task does this periodically.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+#include "xparameters.h"
+
+#define TIMESTAMP_FREQ_HZ     (XPAR_CPU_CORTEXR5_0_CPU_CLK_FREQ_HZ)     ///< Timestamp tick rate
+
+/*******************************************************************************
+*
+* \details
+*
+* This function returns the current 64-bit timestamp.  It is safe to call from
+* both task and interrupt context.
+*
+* \return     Timestamp in TIMESTAMP_FREQ_HZ ticks
+*
+*******************************************************************************/
+uint64_t Timestamp_Get( void );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function converts a timestamp difference to microseconds.
+*
+* \param[in]  Ticks - Number of TIMESTAMP_FREQ_HZ ticks
+*
+* \return     Time in microseconds
+*
+*******************************************************************************/
+uint64_t Timestamp_ToUs( uint64_t Ticks );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function converts a timestamp difference to a number of samples at the
+* provided sample rate.
+*
+* \param[in]  Ticks - Number of TIMESTAMP_FREQ_HZ ticks
+*
+* \param[in]  SampleRate - Sample rate in Hz
+*
+* \return     Number of samples
+*
+*******************************************************************************/
+uint64_t Timestamp_ToSamples( uint64_t Ticks, uint32_t SampleRate );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function enables the PMU cycle counter and resets the timestamp.
+*
+* \return     Status
+*
+*******************************************************************************/
+int32_t Timestamp_Initialize( void );
+
+#endif /* SRC_TIMESTAMP_H_ */
@@ -61,9 +61,17 @@ extern "C"
 #define APP_CLI_RX_TASK_PRIORITY        tskIDLE_PRIORITY
 #define APP_CLI_TX_TASK_PRIORITY        tskIDLE_PRIORITY + 3
 #define PHY_TASK_PRIORITY               tskIDLE_PRIORITY + 2
+#define PHY_RECORD_TASK_PRIORITY        tskIDLE_PRIORITY + 1
+#define PHY_PLAYBACK_TASK_PRIORITY      tskIDLE_PRIORITY + 1
+#define PHY_TRIGGER_TASK_PRIORITY       tskIDLE_PRIORITY + 1
+#define IQ_FILE_TASK_PRIORITY           tskIDLE_PRIORITY + 1
 
 #define APP_TASK_STACK_SIZE             0x8000
 #define PHY_TASK_STACK_SIZE             0x8000
+#define PHY_RECORD_TASK_STACK_SIZE      0x2000
+#define PHY_PLAYBACK_TASK_STACK_SIZE    0x2000
+#define PHY_TRIGGER_TASK_STACK_SIZE     0x2000
+#define IQ_FILE_TASK_STACK_SIZE         0x2000
 #define APP_CLI_RX_STACK_SIZE           8192
 #define APP_CLI_TX_STACK_SIZE           8192
 
@@ -71,10 +79,24 @@ extern "C"
 #define APP_CLI_RX_TASK_NAME            "CliRx"
 #define APP_CLI_TX_TASK_NAME            "CliTx"
 #define PHY_TASK_NAME                   "Phy"
+#define PHY_RECORD_TASK_NAME            "PhyRec"
+#define PHY_PLAYBACK_TASK_NAME          "PhyPlay"
+#define PHY_TRIGGER_TASK_NAME           "PhyTrig"
+#define IQ_FILE_TASK_NAME               "IqFile"
 
 #define APP_CLI_RX_QUEUE_SIZE           2048
 #define APP_CLI_TX_QUEUE_SIZE           32768
 #define PHY_QUEUE_SIZE                  64
+#define PHY_STREAM_POOL_SIZE            4
+#define PHY_STREAM_SPIN_US              200
+#define PHY_STREAM_START_LEAD_US        2000
+#define PHY_RECORD_BLOCK_SAMPLES        32768
+#define PHY_RECORD_BLOCK_CNT            8
+#define PHY_PLAYBACK_BLOCK_SAMPLES      32768
+#define PHY_PLAYBACK_BLOCK_CNT          4
+#define PHY_TRIGGER_BLOCK_SAMPLES       4096
+#define PHY_TRIGGER_BLOCK_CNT           32
+#define IQ_FILE_WRITE_QUEUE_SIZE        8
 
 #define APP_CLI_UART_DEVICE_ID          XPAR_PSU_UART_0_DEVICE_ID
 #define APP_CLI_UART_INTR_ID            XPAR_XUARTPS_0_INTR
@@ -82,6 +104,11 @@ extern "C"
 #define APP_CLI_CMD_BUF_SIZE            2048
 #define APP_CLI_CMD_LIST_SIZE           100
 #define APP_CLI_HISTORY_BUF_SIZE        256
+#define APP_CLI_MEM_POOL_LIST_SIZE      16
+
+#define MEM_DMA_DEVICE_ID               (XPAR_PSU_GDMA_0_DEVICE_ID)
+/* FPD GDMA channel 0 (psu_gdma_0) is GIC SPI 124 */
+#define MEM_DMA_INTR_ID                 (124 + 32)
 
 #define GPIO_DEVICE_ID                  (XPAR_PSU_GPIO_0_DEVICE_ID)
 #define GPIO_OFFSET                     (78)
@@ -48,10 +48,19 @@
 #include "task.h"
 #include "queue.h"
 #include "phy_cli.h"
+#include "phy_record.h"
+#include "phy_playback.h"
+#include "phy_trigger.h"
 #include "parameters.h"
 #include "xscugic.h"
+#include "iq_buf.h"
 #include "adrv9001.h"
 #include "adi_adrv9001_types.h"
+#include "axi_dmac.h"
+#include "error.h"
+#include "timestamp.h"
+
+#define PHY_DMA_QUEUE_DEPTH         (AXI_DMAC_HW_QUEUE_DEPTH) ///< Number of blocks kept queued to the DMA
 
 
 /**
@@ -62,9 +71,9 @@ typedef struct
   enum
   {
     PhyQEvt_StreamStart     = 0,
-    PhyQEvt_StreamStop      = 1,
-    PhyQEvt_StreamRemove    = 2,
-    PhyQEvt_StreamDone      = 3,
+    PhyQEvt_StreamComplete  = 1,
+    PhyQEvt_BlockReady      = 2,
+    PhyQEvt_GroupStart      = 3,
   }Evt;
   union
   {
@@ -74,20 +83,416 @@ typedef struct
       adrv9001_port_t     Port;
       adrv9001_status_t   Status;
     };
+    struct
+    {
+      uint32_t            PortMask;
+      phy_stream_t       *Streams[Adrv9001Port_Num];
+    }Group;
   }Data;
 } phy_queue_t;
 
+/**
+**  PHY Block Ring
+**
+**  Tracks the blocks of a continuous stream using free running sequence
+**  numbers.  Blocks between DoneIdx and QueueIdx are owned by the DMA and
+**  blocks flagged in UserMask are owned by the caller.
+*/
+typedef struct
+{
+  axi_dmac_t           *Dma;            ///< DMA instance
+  axi_dmac_callback_t   DrvCallback;    ///< ADRV9001 driver DMA callback, detached while blocks are queued directly
+  void                 *DrvCallbackRef; ///< ADRV9001 driver DMA callback reference
+  volatile bool         Active;         ///< Blocks may be queued to the DMA
+  volatile bool         Direct;         ///< Single shot is queued to the DMA as one 2D transfer
+  volatile bool         ReadyPending;   ///< Block ready message is pending in queue
+  volatile uint32_t     QueueIdx;       ///< Sequence number of next block queued to the DMA
+  volatile uint32_t     DoneIdx;        ///< Sequence number of next block completed by the DMA
+  volatile uint32_t     ReadyIdx;       ///< Sequence number of next block delivered to the caller
+  volatile uint32_t     UserMask;       ///< Blocks currently owned by the caller
+  volatile uint32_t     OverrunCnt;     ///< Number of times the DMA ran out of blocks
+  volatile uint64_t     EndTimestamp[PHY_STREAM_BLOCK_MAX]; ///< DMA end of transfer time of each block
+} phy_block_ring_t;
+
+/**
+**  PHY Stream Time
+*/
+typedef struct
+{
+  volatile uint64_t     Start;          ///< Start of stream or previous block
+  volatile uint64_t     End;            ///< End of stream
+} phy_stream_time_t;
+
+/**
+**  PHY Stream Slot
+**
+**  A slot is owned by the caller of Phy_IqStreamEnable while it is being
+**  filled, by the PHY queue once sent and by Phy_Task until the stream is
+**  removed at which point it is returned to the pool.
+*/
+typedef struct
+{
+  phy_stream_t          Stream;         ///< Stream Data
+  volatile bool         InUse;          ///< Slot is allocated
+} phy_stream_slot_t;
+
 static QueueHandle_t            PhyQueue;                       ///< PHY Queue
 static phy_stream_t            *PhyStream[Adrv9001Port_Num];    ///< Stream Data
+static phy_block_ring_t         PhyRing[Adrv9001Port_Num];      ///< Continuous Stream Data
+static volatile bool            PhyCompletePending[Adrv9001Port_Num];  ///< Stream complete message is pending in queue
+static phy_stream_time_t        PhyStreamTime[Adrv9001Port_Num];       ///< Stream Timestamps
+static bool                     PhyStreamTimed[Adrv9001Port_Num];      ///< Stream is waiting for its start time
+static bool                     PhyStreamRfOn[Adrv9001Port_Num];       ///< Timed stream has RF enabled, only the DMA waits for the start time
+static phy_stats_t              PhyStats;                              ///< Performance Counters
+static phy_stream_slot_t        PhyStreamPool[Adrv9001Port_Num][PHY_STREAM_POOL_SIZE];  ///< Stream Slot Pool
+static phy_stream_pool_stats_t  PhyStreamPoolStats[Adrv9001Port_Num];                   ///< Stream Slot Pool Statistics
 static adi_adrv9001_Device_t   *Adrv9001;
 extern XScuGic xInterruptController;
 
+static phy_stream_t *Phy_IqStreamSlotAlloc( adrv9001_port_t Port )
+{
+  phy_stream_t *Stream = NULL;
+  phy_stream_pool_stats_t *Stats = &PhyStreamPoolStats[ Port ];
+
+  taskENTER_CRITICAL();
+
+  for( int i = 0; i < PHY_STREAM_POOL_SIZE; i++ )
+  {
+    if( !PhyStreamPool[ Port ][ i ].InUse )
+    {
+      PhyStreamPool[ Port ][ i ].InUse = true;
+      Stream = &PhyStreamPool[ Port ][ i ].Stream;
+      break;
+    }
+  }
+
+  if( Stream != NULL )
+  {
+    Stats->AllocCnt++;
+    Stats->InUse++;
+
+    if( Stats->InUse > Stats->HighWater )
+      Stats->HighWater = Stats->InUse;
+  }
+  else
+  {
+    Stats->ExhaustedCnt++;
+  }
+
+  taskEXIT_CRITICAL();
+
+  return Stream;
+}
+
+static void Phy_IqStreamSlotFree( phy_stream_t *Stream )
+{
+  if( Stream == NULL )
+    return;
+
+  /* Stream is the first member of the slot */
+  phy_stream_slot_t *Slot = (phy_stream_slot_t*)Stream;
+  phy_stream_pool_stats_t *Stats = &PhyStreamPoolStats[ Stream->Port ];
+
+  taskENTER_CRITICAL();
+
+  if( Slot->InUse )
+  {
+    Slot->InUse = false;
+    Stats->FreeCnt++;
+    Stats->InUse--;
+  }
+
+  taskEXIT_CRITICAL();
+}
+
+phy_status_t Phy_GetStreamPoolStats( adrv9001_port_t Port, phy_stream_pool_stats_t *Stats )
+{
+  if( Port >= Adrv9001Port_Num )
+    return PhyStatus_InvalidPort;
+
+  if( Stats == NULL )
+    return PhyStatus_InvalidParameter;
+
+  taskENTER_CRITICAL();
+  *Stats = PhyStreamPoolStats[ Port ];
+  taskEXIT_CRITICAL();
+
+  return PhyStatus_Success;
+}
+
+static void Phy_StatsHist( phy_hist_t *Hist, uint64_t Ticks )
+{
+  uint64_t Us = Timestamp_ToUs( Ticks );
+  uint32_t Bin = 0;
+
+  /* Bin is the number of significant bits of the value in microseconds */
+  while( (Us >> Bin) && (Bin < (PHY_STATS_HIST_BINS - 1)) )
+    Bin++;
+
+  Hist->Bin[ Bin ]++;
+
+  if( Us > Hist->MaxUs )
+    Hist->MaxUs = (Us > UINT32_MAX) ? UINT32_MAX : (uint32_t)Us;
+}
+
+phy_status_t Phy_GetStats( phy_stats_t *Stats )
+{
+  if( Stats == NULL )
+    return PhyStatus_InvalidParameter;
+
+  taskENTER_CRITICAL();
+  *Stats = PhyStats;
+  taskEXIT_CRITICAL();
+
+  return PhyStatus_Success;
+}
+
+phy_status_t Phy_ClearStats( void )
+{
+  taskENTER_CRITICAL();
+  memset( &PhyStats, 0, sizeof(PhyStats) );
+  taskEXIT_CRITICAL();
+
+  return PhyStatus_Success;
+}
+
+/* Samples from the first to the last sample of a block */
+static uint32_t Phy_IqStreamSpan( phy_stream_t *Stream )
+{
+  if( Stream->RowSampleCnt == 0 )
+    return Stream->SampleCnt;
+
+  return (Stream->SampleCnt / Stream->RowSampleCnt - 1) * Stream->RowStride + Stream->RowSampleCnt;
+}
+
+/* Samples from the start of a block to the start of the next block */
+static uint32_t Phy_IqStreamPitch( phy_stream_t *Stream )
+{
+  /* Strided blocks occupy whole rows */
+  if( Stream->RowSampleCnt == 0 )
+    return Stream->SampleCnt;
+
+  return (Stream->SampleCnt / Stream->RowSampleCnt) * Stream->RowStride;
+}
+
+static uint32_t *Phy_IqStreamBlockAddr( phy_stream_t *Stream, uint32_t Seq )
+{
+  return &Stream->SampleBuf[ (Seq % Stream->BlockCnt) * Phy_IqStreamPitch( Stream ) ];
+}
+
+static void Phy_IqStreamDescDone( axi_dmac_desc_t *Desc, void *Param );
+
+/* Must be called from ISR or with interrupts disabled */
+static void Phy_IqStreamQueueBlocks( adrv9001_port_t Port )
+{
+  phy_stream_t *Stream = PhyStream[ Port ];
+  phy_block_ring_t *Ring = &PhyRing[ Port ];
+  uint32_t Depth;
+
+  if( (Stream == NULL) || !Ring->Active )
+    return;
+
+  /* Never queue a block that is already owned by the DMA, coalesced streams
+     keep a batch per hardware transfer queued */
+  Depth = PHY_DMA_QUEUE_DEPTH * ((Stream->BlocksPerIrq > 1) ? Stream->BlocksPerIrq : 1);
+  if( Stream->BlockCnt < Depth )
+    Depth = Stream->BlockCnt;
+
+  while( (Ring->QueueIdx - Ring->DoneIdx) < Depth )
+  {
+    /* Stop at first block still owned by the caller to preserve order */
+    if( Ring->UserMask & (1 << (Ring->QueueIdx % Stream->BlockCnt)) )
+      break;
+
+    /* Stop if DMA descriptor ring is full */
+    if( axi_dmac_desc_submit( Ring->Dma, (uint32_t)Phy_IqStreamBlockAddr( Stream, Ring->QueueIdx ), Stream->SampleCnt * sizeof(uint32_t),
+        Phy_IqStreamDescDone, (void *)Port ) != SUCCESS )
+      break;
+
+    Ring->QueueIdx++;
+  }
+}
+
+static void Phy_IqStreamBlockDone( adrv9001_port_t Port, uint64_t EndTimestamp )
+{
+  phy_stream_t *Stream = PhyStream[ Port ];
+  phy_block_ring_t *Ring = &PhyRing[ Port ];
+
+  if( !Ring->Active || (Ring->QueueIdx == Ring->DoneIdx) )
+    return;
+
+  /* Hand Block to Caller */
+  Ring->EndTimestamp[ Ring->DoneIdx % Stream->BlockCnt ] = EndTimestamp;
+  Ring->UserMask |= 1 << (Ring->DoneIdx % Stream->BlockCnt);
+  Ring->DoneIdx++;
+
+  /* DMA is idle so samples are being dropped */
+  if( Ring->QueueIdx == Ring->DoneIdx )
+    Ring->OverrunCnt++;
+
+  Phy_IqStreamQueueBlocks( Port );
+}
+
+/* Called from the DMA ISR once per completed block */
+static void Phy_IqStreamDescDone( axi_dmac_desc_t *Desc, void *Param )
+{
+  adrv9001_port_t Port = (adrv9001_port_t)Param;
+
+  if( (Port >= Adrv9001Port_Num) || (PhyStream[Port] == NULL) || !PhyRing[Port].Active )
+    return;
+
+  Phy_IqStreamBlockDone( Port, Desc->timestamp );
+
+  /* Notify PHY Task */
+  if( !PhyRing[Port].ReadyPending )
+  {
+    phy_queue_t qItem = {.Evt = PhyQEvt_BlockReady, .Data.Port = Port};
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if( xQueueSendFromISR( PhyQueue, &qItem, &xHigherPriorityTaskWoken ) == pdPASS )
+      PhyRing[Port].ReadyPending = true;
+
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+  }
+}
+
+/* Must be called from ISR, stop, report and remove stream with a single message */
+static void Phy_IqStreamPostComplete( adrv9001_port_t Port, adrv9001_status_t Status )
+{
+  phy_queue_t qItem = {.Evt = PhyQEvt_StreamComplete, .Data.Port = Port, .Data.Status = Status};
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+  if( xQueueSendFromISR( PhyQueue, &qItem, &xHigherPriorityTaskWoken ) == pdPASS )
+    PhyCompletePending[Port] = true;
+
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/* Called from the DMA ISR when a direct single shot completes */
+static void Phy_IqStreamShotDone( axi_dmac_desc_t *Desc, void *Param )
+{
+  adrv9001_port_t Port = (adrv9001_port_t)Param;
+
+  if( (Port >= Adrv9001Port_Num) || (PhyStream[Port] == NULL) || !PhyRing[Port].Direct )
+    return;
+
+  PhyStats.Port[Port].IsrCnt++;
+
+  if( PhyCompletePending[Port] )
+    return;
+
+  /* Capture DMA Timestamps */
+  PhyStreamTime[Port].Start = PhyRing[Port].Dma->sot_timestamp;
+  PhyStreamTime[Port].End = Desc->timestamp;
+
+  Phy_IqStreamPostComplete( Port, (adrv9001_status_t)PhyStatus_Success );
+}
+
+static void Phy_IqStreamBlockReady( adrv9001_port_t Port )
+{
+  phy_stream_t *Stream = PhyStream[ Port ];
+  phy_block_ring_t *Ring = &PhyRing[ Port ];
+
+  if( Stream == NULL )
+    return;
+
+  /* Allow the next block to post a message */
+  Ring->ReadyPending = false;
+
+  while( Ring->Active && (Ring->ReadyIdx != Ring->DoneIdx) )
+  {
+    uint32_t *Block = Phy_IqStreamBlockAddr( Stream, Ring->ReadyIdx );
+    uint64_t EndTimestamp = Ring->EndTimestamp[ Ring->ReadyIdx % Stream->BlockCnt ];
+
+    /* Discard stale cache lines covering the block, ring blocks are written
+       by the DMA directly */
+    if( PHY_IS_PORT_RX( Port ) )
+      IqBuf_Invalidate( Block, Phy_IqStreamSpan( Stream ) * sizeof(uint32_t) );
+
+    phy_evt_data_t PhyEvtData = {
+        .Stream.Port = Port,
+        .Stream.SampleBuf = Block,
+        .Stream.SampleCnt = Stream->SampleCnt,
+        .Stream.Status = PhyStatus_Success,
+        .Stream.CallbackRef = Stream->CallbackRef,
+        .Stream.BlockIdx = Ring->ReadyIdx,
+        .Stream.OverrunCnt = Ring->OverrunCnt,
+        .Stream.StartTimestamp = PhyStreamTime[ Port ].Start,
+        .Stream.EndTimestamp = EndTimestamp
+    };
+
+    /* Next block starts where this one ended */
+    PhyStreamTime[ Port ].Start = EndTimestamp;
+    PhyStreamTime[ Port ].End = EndTimestamp;
+
+    PhyStats.Port[ Port ].ByteCnt += Stream->SampleCnt * sizeof(uint32_t);
+    Phy_StatsHist( &PhyStats.Port[ Port ].IsrLatency, Timestamp_Get() - EndTimestamp );
+
+    Ring->ReadyIdx++;
+
+    if(Stream->Callback != NULL)
+      Stream->Callback( PhyEvtType_BlockReady, PhyEvtData, Stream->CallbackRef );
+  }
+}
+
+phy_status_t Phy_IqStreamBlockRelease( adrv9001_port_t Port, uint32_t *Block )
+{
+  if( Port >= Adrv9001Port_Num )
+    return PhyStatus_InvalidPort;
+
+  phy_status_t status = PhyStatus_InvalidParameter;
+  phy_stream_t *Stream = PhyStream[ Port ];
+
+  /* Write refilled transmit samples back to memory before the DMA reads them,
+     receive blocks are cleaned too so no dirty line lands on new samples */
+  if( (Stream != NULL) && (Stream->BlockCnt > 0) )
+    IqBuf_Flush( Block, Phy_IqStreamSpan( Stream ) * sizeof(uint32_t) );
+
+  taskENTER_CRITICAL();
+
+  Stream = PhyStream[ Port ];
+
+  if( (Stream != NULL) && (Stream->BlockCnt > 0) && (Block >= Stream->SampleBuf) )
+  {
+    uint32_t Offset = Block - Stream->SampleBuf;
+    uint32_t Pitch = Phy_IqStreamPitch( Stream );
+    uint32_t Idx = Offset / Pitch;
+
+    if( (Idx < Stream->BlockCnt) && ((Offset % Pitch) == 0) )
+    {
+      /* Return Block and Queue to DMA */
+      PhyRing[ Port ].UserMask &= ~(1 << Idx);
+      Phy_IqStreamQueueBlocks( Port );
+      status = PhyStatus_Success;
+    }
+  }
+
+  taskEXIT_CRITICAL();
+
+  return status;
+}
+
 static void Phy_IqStreamRemove( adrv9001_port_t Port )
 {
   if( Port < Adrv9001Port_Num )
   {
-    /* Free Stream Data */
-    free( PhyStream[ Port ] );
+    /* Clear Continuous Stream Data */
+    PhyRing[ Port ].Active = false;
+    PhyRing[ Port ].Direct = false;
+
+    if( PhyRing[ Port ].Dma != NULL )
+    {
+      axi_dmac_set_callback( PhyRing[ Port ].Dma, PhyRing[ Port ].DrvCallback, PhyRing[ Port ].DrvCallbackRef );
+      axi_dmac_set_stride( PhyRing[ Port ].Dma, 0, 0 );
+      axi_dmac_set_irq_coalesce( PhyRing[ Port ].Dma, 1, true );
+    }
+
+    /* Cancel Pending Start */
+    PhyStreamTimed[ Port ] = false;
+    PhyStreamRfOn[ Port ] = false;
+
+    /* Return Stream Slot */
+    Phy_IqStreamSlotFree( PhyStream[ Port ] );
 
     /* Clear Stream Data */
     PhyStream[ Port ] = NULL;
@@ -101,6 +506,11 @@ static void Phy_IqStreamStop( adrv9001_port_t Port )
   /* Check if Valid */
   if( (Stream != NULL) && (Port < Adrv9001Port_Num) )
   {
+    /* Stop Queuing Blocks */
+    taskENTER_CRITICAL();
+    PhyRing[ Port ].Active = false;
+    taskEXIT_CRITICAL();
+
     /* Disable RF */
     if( Adrv9001_ToRfCalibrated( Port ) != Adrv9001Status_Success )
       Stream->Status = PhyStatus_RadioStateError;
@@ -118,29 +528,171 @@ static void Phy_IqStreamDone( adrv9001_port_t Port, adrv9001_status_t Status )
   if(( Stream == NULL) || (Port >= Adrv9001Port_Num))
     return;
 
+  /* Update Counters */
+  phy_port_stats_t *Stats = &PhyStats.Port[ Port ];
+
+  if( (phy_status_t)Status == PhyStatus_Success )
+  {
+    Stats->CompleteCnt++;
+
+    if( Stream->BlockCnt == 0 )
+    {
+      Stats->ByteCnt += Stream->SampleCnt * sizeof(uint32_t);
+      Phy_StatsHist( &Stats->IsrLatency, Timestamp_Get() - PhyStreamTime[ Port ].End );
+    }
+  }
+  else if( (phy_status_t)Status == PhyStatus_IqStreamAbort )
+  {
+    Stats->AbortCnt++;
+  }
+  else
+  {
+    Stats->ErrorCnt++;
+  }
+
+  /* Discard stale cache lines covering a direct single shot.  Other single
+     shots are copied from the driver staging buffer by the processor, the
+     cache holds them and must not be invalidated. */
+  if( PhyRing[ Port ].Direct && PHY_IS_PORT_RX( Port ) )
+    IqBuf_Invalidate( Stream->SampleBuf, Phy_IqStreamSpan( Stream ) * sizeof(uint32_t) );
+
+  if( PHY_IS_PORT_RX( Port ) )
+    Stats->OverrunCnt += PhyRing[ Port ].OverrunCnt;
+  else
+    Stats->UnderrunCnt += PhyRing[ Port ].OverrunCnt;
+
   /* Send Stream Error */
   phy_evt_data_t PhyEvtData = {
       .Stream.Port = Port,
       .Stream.SampleBuf = Stream->SampleBuf,
       .Stream.SampleCnt = Stream->SampleCnt,
       .Stream.Status = Status,
-      .Stream.CallbackRef = Stream->CallbackRef
+      .Stream.CallbackRef = Stream->CallbackRef,
+      .Stream.BlockIdx = PhyRing[ Port ].ReadyIdx,
+      .Stream.OverrunCnt = PhyRing[ Port ].OverrunCnt,
+      .Stream.StartTimestamp = PhyStreamTime[ Port ].Start,
+      .Stream.EndTimestamp = PhyStreamTime[ Port ].End
   };
 
   if(Stream->Callback != NULL)
     Stream->Callback( PhyEvtType_StreamDone, PhyEvtData, Stream->CallbackRef );
 }
 
-static void Phy_IqStreamStart( phy_stream_t *Stream )
+static void Phy_IqStreamStarted( phy_stream_t *Stream, uint64_t Timestamp, uint64_t GroupSkew )
 {
-  if( Stream == NULL )
-    return;
+  PhyStats.Port[ Stream->Port ].StartCnt++;
 
-  /* Copy Stream Reference */
-  PhyStream[ Stream->Port ] = Stream;
+  /* Record Enable Time */
+  PhyStreamTime[ Stream->Port ].Start = Timestamp;
+  PhyStreamTime[ Stream->Port ].End = Timestamp;
+
+  /* Send Stream Start */
+  phy_evt_data_t PhyEvtData = {
+      .Stream.Port = Stream->Port ,
+      .Stream.SampleBuf = Stream->SampleBuf,
+      .Stream.SampleCnt = Stream->SampleCnt,
+      .Stream.Status = PhyStatus_Success,
+      .Stream.CallbackRef = Stream->CallbackRef,
+      .Stream.StartTimestamp = Timestamp,
+      .Stream.EndTimestamp = Timestamp,
+      .Stream.GroupSkew = GroupSkew
+  };
+
+  if(Stream->Callback != NULL)
+    Stream->Callback( PhyEvtType_StreamStart, PhyEvtData, Stream->CallbackRef );
+}
+
+/* Hand the stream to the DMA.  Continuous streams queue every block straight
+   to the DMA and strided single shots are queued as one 2D transfer.  Other
+   single shot and cyclic streams go through the ADRV9001 driver, which moves
+   the samples through its staging buffer. */
+static phy_status_t Phy_IqStreamArm( phy_stream_t *Stream )
+{
+  phy_block_ring_t *Ring = &PhyRing[ Stream->Port ];
+  bool Queued;
+
+  if( Ring->Active )
+  {
+    taskENTER_CRITICAL();
+    Phy_IqStreamQueueBlocks( Stream->Port );
+    Queued = (Ring->QueueIdx != Ring->DoneIdx);
+    taskEXIT_CRITICAL();
+
+    return Queued ? PhyStatus_Success : PhyStatus_DmaError;
+  }
+
+  if( Ring->Direct )
+  {
+    if( axi_dmac_desc_submit_2d( Ring->Dma, (uint32_t)Stream->SampleBuf, Stream->RowSampleCnt * sizeof(uint32_t),
+        Stream->SampleCnt / Stream->RowSampleCnt, Stream->RowStride * sizeof(uint32_t),
+        Phy_IqStreamShotDone, (void *)Stream->Port ) != SUCCESS )
+      return PhyStatus_DmaError;
+
+    return PhyStatus_Success;
+  }
+
+  if( Adrv9001_IQStream( Stream->Port, Stream->Cyclic, (adrv9001_iqdata_t*)Stream->SampleBuf, Stream->SampleCnt ) != Adrv9001Status_Success )
+    return PhyStatus_Adrv9001Error;
+
+  return PhyStatus_Success;
+}
+
+/* Enable RF and record how long the enable took */
+static phy_status_t Phy_IqStreamEnableRf( adrv9001_port_t Port )
+{
+  uint64_t EnableStart = Timestamp_Get();
+
+  if( Adrv9001_ToRfEnabled( Port ) != Adrv9001Status_Success )
+    return PhyStatus_RadioStateError;
+
+  Phy_StatsHist( &PhyStats.Port[ Port ].EnableTime, Timestamp_Get() - EnableStart );
 
+  return PhyStatus_Success;
+}
+
+/* DMA start of transfer time of a stream armed at Armed.  The start of
+   transfer interrupt may still be pending, it is waited for up to
+   PHY_STREAM_SPIN_US after which the arm time is used. */
+static uint64_t Phy_IqStreamSot( adrv9001_port_t Port, uint64_t Armed )
+{
+  axi_dmac_t *Dma = PhyRing[ Port ].Dma;
+  uint64_t Spin = ((uint64_t)PHY_STREAM_SPIN_US * TIMESTAMP_FREQ_HZ) / 1000000;
+
+  if( Dma == NULL )
+    return Armed;
+
+  while( (Dma->sot_timestamp < Armed) && (Timestamp_Get() < (Armed + Spin)) );
+
+  return (Dma->sot_timestamp >= Armed) ? Dma->sot_timestamp : Armed;
+}
+
+/* Start the DMA of a stream whose RF is already enabled */
+static void Phy_IqStreamGo( phy_stream_t *Stream )
+{
+  phy_status_t Status;
+  uint64_t Armed = Timestamp_Get();
+
+  if((Status = Phy_IqStreamArm( Stream )) != PhyStatus_Success)
+  {
+    /* Attempt Stop Current Stream */
+    Phy_IqStreamStop( Stream->Port );
+
+    /* Abort Stream */
+    Phy_IqStreamDone( Stream->Port, Status );
+
+    /* Remove Stream */
+    Phy_IqStreamRemove( Stream->Port );
+  }
+  else
+  {
+    Phy_IqStreamStarted( Stream, Phy_IqStreamSot( Stream->Port, Armed ), 0 );
+  }
+}
+
+static void Phy_IqStreamRun( phy_stream_t *Stream )
+{
   /* Enable RF */
-  if( Adrv9001_ToRfEnabled( Stream->Port ) != Adrv9001Status_Success )
+  if( Phy_IqStreamEnableRf( Stream->Port ) != PhyStatus_Success )
   {
     /* Abort Stream */
     Phy_IqStreamDone( Stream->Port, PhyStatus_RadioStateError );
@@ -149,31 +701,301 @@ static void Phy_IqStreamStart( phy_stream_t *Stream )
     Phy_IqStreamRemove( Stream->Port );
   }
   /* Enable Streaming */
-  else if(Adrv9001_IQStream( Stream->Port, Stream->Cyclic, (adrv9001_iqdata_t*)Stream->SampleBuf, Stream->SampleCnt ) != Adrv9001Status_Success)
+  else
   {
-    /* Attempt Stop Current Stream */
+    Phy_IqStreamGo( Stream );
+  }
+}
+
+/* Time to enable RF ahead of the start time, 0 if the start time is closer
+   to 0 than the lead so the stream is always late.  The lead is never less
+   than the slowest enable seen on the port. */
+static uint64_t Phy_IqStreamEnableTime( phy_stream_t *Stream )
+{
+  uint32_t LeadUs = PHY_STREAM_START_LEAD_US;
+
+  if( PhyStats.Port[ Stream->Port ].EnableTime.MaxUs > LeadUs )
+    LeadUs = PhyStats.Port[ Stream->Port ].EnableTime.MaxUs;
+
+  uint64_t Lead = ((uint64_t)LeadUs * TIMESTAMP_FREQ_HZ) / 1000000;
+
+  return (Stream->StartTime > Lead) ? (Stream->StartTime - Lead) : 0;
+}
+
+/* Time the timed stream on a port next needs the PHY task */
+static uint64_t Phy_IqStreamFireTime( adrv9001_port_t Port )
+{
+  phy_stream_t *Stream = PhyStream[ Port ];
+
+  return PhyStreamRfOn[ Port ] ? Stream->StartTime : Phy_IqStreamEnableTime( Stream );
+}
+
+static void Phy_IqStreamSchedule( phy_stream_t *Stream )
+{
+  /* Prime RF ahead of the start time */
+  if( Adrv9001_ToRfPrimed( Stream->Port ) != Adrv9001Status_Success )
+  {
+    /* Abort Stream */
+    Phy_IqStreamDone( Stream->Port, PhyStatus_RadioStateError );
+
+    /* Remove Stream */
+    Phy_IqStreamRemove( Stream->Port );
+  }
+  else if( Timestamp_Get() >= Phy_IqStreamEnableTime( Stream ) )
+  {
+    /* Return RF to Calibrated */
     Phy_IqStreamStop( Stream->Port );
 
     /* Abort Stream */
-    Phy_IqStreamDone( Stream->Port, PhyStatus_Adrv9001Error );
+    Phy_IqStreamDone( Stream->Port, PhyStatus_StreamLate );
 
     /* Remove Stream */
     Phy_IqStreamRemove( Stream->Port );
   }
   else
   {
-    /* Send Stream Error */
-    phy_evt_data_t PhyEvtData = {
-        .Stream.Port = Stream->Port ,
-        .Stream.SampleBuf = Stream->SampleBuf,
-        .Stream.SampleCnt = Stream->SampleCnt,
-        .Stream.Status = PhyStatus_Success,
-        .Stream.CallbackRef = Stream->CallbackRef
-    };
+    /* Wait for Enable Time */
+    PhyStreamRfOn[ Stream->Port ] = false;
+    PhyStreamTimed[ Stream->Port ] = true;
+  }
+}
 
-    if(Stream->Callback != NULL)
-      Stream->Callback( PhyEvtType_StreamStart, PhyEvtData, Stream->CallbackRef );
+static TickType_t Phy_IqStreamTimedWait( void )
+{
+  TickType_t Wait = portMAX_DELAY;
+  uint64_t Spin = ((uint64_t)PHY_STREAM_SPIN_US * TIMESTAMP_FREQ_HZ) / 1000000;
+  uint64_t Now = Timestamp_Get();
+
+  for( adrv9001_port_t Port = 0; Port < Adrv9001Port_Num; Port++ )
+  {
+    if( PhyStreamTimed[ Port ] )
+    {
+      uint64_t Fire = Phy_IqStreamFireTime( Port );
+      uint64_t Wake = (Fire > Spin) ? (Fire - Spin) : 0;
+      TickType_t Ticks = (Wake > Now) ? pdMS_TO_TICKS( Timestamp_ToUs( Wake - Now ) / 1000 ) : 0;
+
+      if( Ticks < Wait )
+        Wait = Ticks;
+    }
+  }
+
+  return Wait;
+}
+
+static void Phy_IqStreamTimedService( void )
+{
+  uint64_t Spin = ((uint64_t)PHY_STREAM_SPIN_US * TIMESTAMP_FREQ_HZ) / 1000000;
+
+  for( adrv9001_port_t Port = 0; Port < Adrv9001Port_Num; Port++ )
+  {
+    if( PhyStreamTimed[ Port ] && ((Timestamp_Get() + Spin) >= Phy_IqStreamFireTime( Port )) )
+    {
+      phy_stream_t *Stream = PhyStream[ Port ];
+
+      if( !PhyStreamRfOn[ Port ] )
+      {
+        /* Enable RF early so only the DMA is left at the start time */
+        if( Phy_IqStreamEnableRf( Port ) != PhyStatus_Success )
+        {
+          /* Return RF to Calibrated */
+          Phy_IqStreamStop( Port );
+
+          /* Abort Stream */
+          Phy_IqStreamDone( Port, PhyStatus_RadioStateError );
+
+          /* Remove Stream */
+          Phy_IqStreamRemove( Port );
+        }
+        else if( Timestamp_Get() >= Stream->StartTime )
+        {
+          /* Return RF to Calibrated */
+          Phy_IqStreamStop( Port );
+
+          /* Abort Stream */
+          Phy_IqStreamDone( Port, PhyStatus_StreamLate );
+
+          /* Remove Stream */
+          Phy_IqStreamRemove( Port );
+        }
+        else
+        {
+          PhyStreamRfOn[ Port ] = true;
+        }
+      }
+      else
+      {
+        PhyStreamTimed[ Port ] = false;
+        PhyStreamRfOn[ Port ] = false;
+
+        /* Spin out the remaining time */
+        while( Timestamp_Get() < Stream->StartTime );
+
+        Phy_IqStreamGo( Stream );
+      }
+    }
+  }
+}
+
+static void Phy_IqStreamInit( phy_stream_t *Stream )
+{
+  /* Copy Stream Reference */
+  PhyStream[ Stream->Port ] = Stream;
+
+  /* Initialize Continuous Stream */
+  phy_block_ring_t *Ring = &PhyRing[ Stream->Port ];
+  Ring->QueueIdx      = 0;
+  Ring->DoneIdx       = 0;
+  Ring->ReadyIdx      = 0;
+  Ring->UserMask      = 0;
+  Ring->OverrunCnt    = 0;
+  Ring->ReadyPending  = false;
+  Ring->Active        = (Stream->BlockCnt > 0);
+  Ring->Direct        = (Stream->BlockCnt == 0) && (Stream->RowSampleCnt > 0);
+
+  /* Blocks of a continuous stream and direct single shots are completed by
+     their descriptors.  The driver callback copies its staging buffer into
+     the last buffer it was given on every completion, it is detached while
+     the PHY owns the DMA. */
+  if( Ring->Dma != NULL )
+  {
+    if( Ring->Active || Ring->Direct )
+    {
+      axi_dmac_set_callback( Ring->Dma, NULL, NULL );
+      Ring->Dma->flags &= ~DMA_CYCLIC;
+    }
+    else
+    {
+      axi_dmac_set_callback( Ring->Dma, Ring->DrvCallback, Ring->DrvCallbackRef );
+    }
+
+    /* Continuous streams only need the end of transfer interrupt */
+    if( Ring->Active && (Stream->BlocksPerIrq > 0) )
+      axi_dmac_set_irq_coalesce( Ring->Dma, Stream->BlocksPerIrq, false );
+    else
+      axi_dmac_set_irq_coalesce( Ring->Dma, 1, true );
   }
+
+  /* Write prefilled transmit samples back to memory.  Receive buffers are
+     reused from the arena and may hold dirty lines from earlier users, they
+     are cleaned and discarded before the DMA writes them. */
+  if( Ring->Active )
+    IqBuf_Flush( Stream->SampleBuf, (Phy_IqStreamBlockAddr( Stream, Stream->BlockCnt - 1 ) - Stream->SampleBuf + Phy_IqStreamSpan( Stream )) * sizeof(uint32_t) );
+  else
+    IqBuf_Flush( Stream->SampleBuf, Phy_IqStreamSpan( Stream ) * sizeof(uint32_t) );
+
+  /* Lay out every block of a continuous stream in rows, a direct single shot
+     carries its own layout and the driver staging buffer is contiguous */
+  if( Ring->Dma != NULL )
+  {
+    if( Ring->Active )
+      axi_dmac_set_stride( Ring->Dma, Stream->RowSampleCnt * sizeof(uint32_t), Stream->RowStride * sizeof(uint32_t) );
+    else
+      axi_dmac_set_stride( Ring->Dma, 0, 0 );
+  }
+}
+
+static void Phy_IqStreamStart( phy_stream_t *Stream )
+{
+  if( Stream == NULL )
+    return;
+
+  Phy_IqStreamInit( Stream );
+
+  if( Stream->StartTime == 0 )
+    Phy_IqStreamRun( Stream );
+  else
+    Phy_IqStreamSchedule( Stream );
+}
+
+static void Phy_IqStreamGroupStart( uint32_t PortMask, phy_stream_t *Streams[] )
+{
+  phy_status_t Status = PhyStatus_Success;
+  uint64_t Armed[Adrv9001Port_Num] = {0};
+  uint64_t Sot[Adrv9001Port_Num] = {0};
+  uint64_t First = UINT64_MAX;
+  uint64_t Last = 0;
+  adrv9001_port_t Port;
+
+  for( Port = 0; Port < Adrv9001Port_Num; Port++ )
+    if( PortMask & PHY_PORT_MASK( Port ) )
+      Phy_IqStreamInit( Streams[ Port ] );
+
+  /* Prime all channels */
+  for( Port = 0; (Port < Adrv9001Port_Num) && (Status == PhyStatus_Success); Port++ )
+    if( PortMask & PHY_PORT_MASK( Port ) )
+      if( Adrv9001_ToRfPrimed( Port ) != Adrv9001Status_Success )
+        Status = PhyStatus_RadioStateError;
+
+  /* Enable all channels, each enable is a mailbox command so they are kept
+     out of the window between the ports starting */
+  for( Port = 0; (Port < Adrv9001Port_Num) && (Status == PhyStatus_Success); Port++ )
+    if( PortMask & PHY_PORT_MASK( Port ) )
+      Status = Phy_IqStreamEnableRf( Port );
+
+  /* Arm all DMAs back to back, samples move as soon as each is armed */
+  for( Port = 0; (Port < Adrv9001Port_Num) && (Status == PhyStatus_Success); Port++ )
+  {
+    if( PortMask & PHY_PORT_MASK( Port ) )
+    {
+      Armed[ Port ] = Timestamp_Get();
+      Status = Phy_IqStreamArm( Streams[ Port ] );
+    }
+  }
+
+  /* Skew is the spread of the DMA start of transfer times */
+  for( Port = 0; (Port < Adrv9001Port_Num) && (Status == PhyStatus_Success); Port++ )
+  {
+    if( PortMask & PHY_PORT_MASK( Port ) )
+    {
+      Sot[ Port ] = Phy_IqStreamSot( Port, Armed[ Port ] );
+      First = (Sot[ Port ] < First) ? Sot[ Port ] : First;
+      Last = (Sot[ Port ] > Last) ? Sot[ Port ] : Last;
+    }
+  }
+
+  for( Port = 0; Port < Adrv9001Port_Num; Port++ )
+  {
+    if( PortMask & PHY_PORT_MASK( Port ) )
+    {
+      if( Status == PhyStatus_Success )
+      {
+        Phy_IqStreamStarted( Streams[ Port ], Sot[ Port ], Last - First );
+      }
+      else
+      {
+        /* Attempt Stop Current Stream */
+        Phy_IqStreamStop( Port );
+
+        /* Abort Stream */
+        Phy_IqStreamDone( Port, Status );
+
+        /* Remove Stream */
+        Phy_IqStreamRemove( Port );
+      }
+    }
+  }
+}
+
+static void Phy_IqStreamComplete( adrv9001_port_t Port, adrv9001_status_t Status )
+{
+  if( Port >= Adrv9001Port_Num )
+    return;
+
+  /* Aborted streams end now */
+  if( (phy_status_t)Status == PhyStatus_IqStreamAbort )
+    PhyStreamTime[ Port ].End = Timestamp_Get();
+
+  /* Disable Stream */
+  Phy_IqStreamStop( Port );
+
+  /* Process Stream Done */
+  Phy_IqStreamDone( Port, Status );
+
+  /* Remove Stream */
+  Phy_IqStreamRemove( Port );
+
+  /* Allow the next completion to post a message */
+  PhyCompletePending[ Port ] = false;
 }
 
 static void Phy_Task( void *pvParameters )
@@ -182,106 +1004,240 @@ static void Phy_Task( void *pvParameters )
 
   for( ;; )
   {
-    /* Wait for Message */
-    xQueueReceive( PhyQueue, (void *)&qItem, portMAX_DELAY);
-
-    /* Process Message */
-    switch( qItem.Evt )
+    /* Wait for Message or next timed stream */
+    if( xQueueReceive( PhyQueue, (void *)&qItem, Phy_IqStreamTimedWait( ) ) == pdPASS )
     {
-      case PhyQEvt_StreamStart:     Phy_IqStreamStart( qItem.Data.Stream );                   break;
-      case PhyQEvt_StreamStop:      Phy_IqStreamStop( qItem.Data.Port );                      break;
-      case PhyQEvt_StreamRemove:    Phy_IqStreamRemove( qItem.Data.Port );                    break;
-      case PhyQEvt_StreamDone:      Phy_IqStreamDone( qItem.Data.Port, qItem.Data.Status );   break;
+      /* Track queue depth including the message just received */
+      UBaseType_t Depth = uxQueueMessagesWaiting( PhyQueue ) + 1;
+
+      if( Depth > PhyStats.QueueHighWater )
+        PhyStats.QueueHighWater = Depth;
+
+      /* Process Message */
+      switch( qItem.Evt )
+      {
+        case PhyQEvt_StreamStart:     Phy_IqStreamStart( qItem.Data.Stream );                   break;
+        case PhyQEvt_StreamComplete:  Phy_IqStreamComplete( qItem.Data.Port, qItem.Data.Status ); break;
+        case PhyQEvt_BlockReady:      Phy_IqStreamBlockReady( qItem.Data.Port );                break;
+        case PhyQEvt_GroupStart:      Phy_IqStreamGroupStart( qItem.Data.Group.PortMask, qItem.Data.Group.Streams ); break;
+      }
     }
+
+    /* Start any stream whose start time has arrived */
+    Phy_IqStreamTimedService( );
   }
 }
 
 static void Phy_Adrv9001Callback( adrv9001_evt_type_t EvtType, adrv9001_evt_data_t EvtData, void *param )
 {
-  if(EvtType == Adrv9001EvtType_StreamDone)
-  {
-    PhyStream[EvtData.Stream.Port]->Status = EvtData.Stream.Status;
+  adrv9001_port_t Port = EvtData.Stream.Port;
 
-    phy_queue_t qItem = {.Data.Port = EvtData.Stream.Port, .Data.Status = EvtData.Stream.Status};
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  if( (Port >= Adrv9001Port_Num) || (PhyStream[Port] == NULL) )
+    return;
 
-    /* Disable Stream */
-    qItem.Evt = PhyQEvt_StreamStop;
-    xQueueSendFromISR( PhyQueue, &qItem, &xHigherPriorityTaskWoken );
-    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+  PhyStats.Port[Port].IsrCnt++;
 
-    /* Process Stream Done */
-    qItem.Evt = PhyQEvt_StreamDone;
-    xQueueSendFromISR( PhyQueue, &qItem, &xHigherPriorityTaskWoken );
-    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+  /* Streams queued directly own the DMA and are completed by their descriptors */
+  if( PhyRing[Port].Active || PhyRing[Port].Direct )
+    return;
 
-    /* Remove Stream */
-    qItem.Evt = PhyQEvt_StreamRemove;
-    xQueueSendFromISR( PhyQueue, &qItem, &xHigherPriorityTaskWoken );
-    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+  if((EvtType == Adrv9001EvtType_StreamDone) && !PhyCompletePending[Port])
+  {
+    PhyStream[Port]->Status = EvtData.Stream.Status;
+
+    /* Capture DMA Timestamps */
+    if( PhyRing[Port].Dma != NULL )
+    {
+      PhyStreamTime[Port].Start = PhyRing[Port].Dma->sot_timestamp;
+      PhyStreamTime[Port].End = PhyRing[Port].Dma->eot_timestamp;
+    }
+
+    Phy_IqStreamPostComplete( Port, EvtData.Stream.Status );
   }
 }
 
 phy_status_t Phy_IqStreamDisable( adrv9001_port_t Port )
 {
-  /* Create Queue Item */
-  phy_queue_t qItem = {.Data.Port = Port, .Data.Status = PhyStatus_IqStreamAbort};
+  if( Port >= Adrv9001Port_Num )
+    return PhyStatus_InvalidPort;
 
-  /* Stop Stream */
-  qItem.Evt = PhyQEvt_StreamStop;
-  if( xQueueSend( PhyQueue, &qItem, 1) != pdPASS )
-    return PhyStatus_Busy;
+  /* Create Queue Item */
+  phy_queue_t qItem = {.Evt = PhyQEvt_StreamComplete, .Data.Port = Port, .Data.Status = PhyStatus_IqStreamAbort};
+  phy_status_t status = PhyStatus_Success;
 
-  /* Abort Stream */
-  qItem.Evt = PhyQEvt_StreamDone;
-  if( xQueueSend( PhyQueue, &qItem, 1) != pdPASS )
-    return PhyStatus_Busy;
+  /* A completion already queued stops the stream ahead of any later request */
+  taskENTER_CRITICAL();
+  bool Pending = PhyCompletePending[ Port ];
+  PhyCompletePending[ Port ] = true;
+  taskEXIT_CRITICAL();
 
-  /* Remove Stream */
-  qItem.Evt = PhyQEvt_StreamRemove;
-  if( xQueueSend( PhyQueue, &qItem, 1) != pdPASS )
-    return PhyStatus_Busy;
+  if( !Pending && (xQueueSend( PhyQueue, &qItem, 1) != pdPASS) )
+  {
+    PhyCompletePending[ Port ] = false;
+    status = PhyStatus_Busy;
+  }
 
-  return PhyStatus_Success;
+  return status;
 }
 
-phy_status_t Phy_IqStreamEnable( phy_stream_t *Stream )
+static phy_status_t Phy_IqStreamValidate( phy_stream_t *Stream )
 {
   if( Stream == NULL )
     return PhyStatus_InvalidParameter;
 
+  if( Stream->Port >= Adrv9001Port_Num )
+    return PhyStatus_InvalidPort;
+
   if( (Stream->SampleBuf == NULL) || (Stream->SampleCnt == 0) )
     return PhyStatus_InvalidParameter;
 
   if( Stream->Callback == NULL )
     return PhyStatus_InvalidParameter;
 
+  if( Stream->BlockCnt > 0 )
+  {
+    if( Stream->Cyclic )
+      return PhyStatus_NotSupported;
+
+    if( (Stream->BlockCnt < 2) || (Stream->BlockCnt > PHY_STREAM_BLOCK_MAX) )
+      return PhyStatus_InvalidParameter;
+
+    /* Blocks larger than a single DMA transfer are split by the descriptor ring */
+    if( PhyRing[ Stream->Port ].Dma == NULL )
+      return PhyStatus_InvalidParameter;
+
+    /* The caller must be able to hold one batch while the DMA fills another */
+    if( Stream->BlocksPerIrq > (Stream->BlockCnt / 2) )
+      return PhyStatus_InvalidParameter;
+  }
+  else if( Stream->BlocksPerIrq > 0 )
+  {
+    return PhyStatus_InvalidParameter;
+  }
+
+  if( Stream->RowSampleCnt > 0 )
+  {
+    bool Supported = false;
+
+    if( PhyRing[ Stream->Port ].Dma != NULL )
+      axi_dmac_is_2d_supported( PhyRing[ Stream->Port ].Dma, &Supported );
+
+    /* The driver staging buffer of a cyclic stream is contiguous */
+    if( !Supported || Stream->Cyclic )
+      return PhyStatus_NotSupported;
+
+    /* Whole rows that never share a cache line with another stream */
+    if( (Stream->SampleCnt % Stream->RowSampleCnt) || (Stream->RowStride < Stream->RowSampleCnt) ||
+        ((Stream->RowSampleCnt * sizeof(uint32_t)) % IQ_BUF_ALIGN) || ((Stream->RowStride * sizeof(uint32_t)) % IQ_BUF_ALIGN) )
+      return PhyStatus_InvalidParameter;
+
+    /* Each block is a single 2D transfer */
+    if( ((Stream->SampleCnt / Stream->RowSampleCnt - 1) > PhyRing[ Stream->Port ].Dma->y_max) ||
+        ((Stream->RowSampleCnt * sizeof(uint32_t) - 1) > PhyRing[ Stream->Port ].Dma->transfer_max_size) )
+      return PhyStatus_InvalidParameter;
+  }
+
+  return PhyStatus_Success;
+}
+
+phy_status_t Phy_IqStreamEnable( phy_stream_t *Stream )
+{
+  phy_status_t status;
+
+  if((status = Phy_IqStreamValidate( Stream )) != PhyStatus_Success)
+    return status;
+
   /* Disable Current Streams on Same Port */
   Phy_IqStreamDisable( Stream->Port );
 
   /* Create Queue Item */
   phy_queue_t qItem = { .Evt = PhyQEvt_StreamStart };
 
-  /* Create New Stream */
-  if((qItem.Data.Stream = calloc(1, sizeof(phy_stream_t))) == NULL)
-    return PhyStatus_MemoryError;
+  /* Take Stream Slot */
+  if((qItem.Data.Stream = Phy_IqStreamSlotAlloc( Stream->Port )) == NULL)
+    return PhyStatus_StreamPoolEmpty;
 
   /* Initialize Status */
   Stream->Status = PhyStatus_Success;
 
   /* Copy Stream */
-  memcpy((uint8_t*)qItem.Data.Stream, (uint8_t*)Stream, sizeof(phy_stream_t));
+  *qItem.Data.Stream = *Stream;
 
   /* Send to PHY Task */
   if( xQueueSend( PhyQueue, &qItem, 1) != pdPASS )
   {
-    free(qItem.Data.Stream);
+    Phy_IqStreamSlotFree( qItem.Data.Stream );
     return PhyStatus_Busy;
   }
 
   return PhyStatus_Success;
 }
 
+phy_status_t Phy_IqStreamGroupEnable( uint32_t PortMask, phy_stream_t *Streams[] )
+{
+  phy_status_t status;
+  adrv9001_port_t Port;
+
+  if( (Streams == NULL) || (PortMask == 0) || (PortMask >= PHY_PORT_MASK( Adrv9001Port_Num )) )
+    return PhyStatus_InvalidParameter;
+
+  for( Port = 0; Port < Adrv9001Port_Num; Port++ )
+  {
+    if( PortMask & PHY_PORT_MASK( Port ) )
+    {
+      if((status = Phy_IqStreamValidate( Streams[ Port ] )) != PhyStatus_Success)
+        return status;
+
+      if( Streams[ Port ]->Port != Port )
+        return PhyStatus_InvalidPort;
+
+      if( Streams[ Port ]->StartTime != 0 )
+        return PhyStatus_NotSupported;
+    }
+  }
+
+  /* Create Queue Item */
+  phy_queue_t qItem = { .Evt = PhyQEvt_GroupStart, .Data.Group.PortMask = PortMask };
+
+  for( Port = 0; Port < Adrv9001Port_Num; Port++ )
+  {
+    if( PortMask & PHY_PORT_MASK( Port ) )
+    {
+      /* Disable Current Streams on Same Port */
+      Phy_IqStreamDisable( Port );
+
+      /* Take Stream Slot */
+      if((qItem.Data.Group.Streams[ Port ] = Phy_IqStreamSlotAlloc( Port )) == NULL)
+      {
+        status = PhyStatus_StreamPoolEmpty;
+        break;
+      }
+
+      /* Initialize Status */
+      Streams[ Port ]->Status = PhyStatus_Success;
+
+      /* Copy Stream */
+      *qItem.Data.Group.Streams[ Port ] = *Streams[ Port ];
+    }
+  }
+
+  /* Send to PHY Task */
+  if( Port == Adrv9001Port_Num )
+  {
+    if( xQueueSend( PhyQueue, &qItem, 1) == pdPASS )
+      return PhyStatus_Success;
+
+    status = PhyStatus_Busy;
+  }
+
+  /* Return Stream Slots */
+  for( Port = 0; Port < Adrv9001Port_Num; Port++ )
+    if( qItem.Data.Group.Streams[ Port ] != NULL )
+      Phy_IqStreamSlotFree( qItem.Data.Group.Streams[ Port ] );
+
+  return status;
+}
+
 phy_status_t Phy_UpdateProfile( profile_t *Profile )
 {
   int32_t status = PhyStatus_NotSupported;
@@ -313,6 +1269,10 @@ phy_status_t Phy_Initialize( void )
   for(adrv9001_port_t i = 0; i < Adrv9001Port_Num; i++)
     PhyStream[i] = NULL;
 
+  /* Clear Stream Slot Pool */
+  memset( PhyStreamPool, 0, sizeof(PhyStreamPool) );
+  memset( PhyStreamPoolStats, 0, sizeof(PhyStreamPoolStats) );
+
   /* Create Queue */
   PhyQueue = xQueueCreate(PHY_QUEUE_SIZE, sizeof(phy_queue_t));
 
@@ -324,6 +1284,18 @@ phy_status_t Phy_Initialize( void )
   if((status = PhyCli_Initialize()) != PhyStatus_Success)
     return status;
 
+  /* Initialize PHY Record */
+  if((status = PhyRecord_Initialize()) != PhyStatus_Success)
+    return status;
+
+  /* Initialize PHY Playback */
+  if((status = PhyPlayback_Initialize()) != PhyStatus_Success)
+    return status;
+
+  /* Initialize PHY Trigger */
+  if((status = PhyTrigger_Initialize()) != PhyStatus_Success)
+    return status;
+
   adrv9001_dma_cfg_t DmaCfg;
 
   DmaCfg.BaseAddr[Adrv9001Port_Tx1] = XPAR_ADRV9001_TX1_DMA_BASEADDR;
@@ -374,6 +1346,19 @@ phy_status_t Phy_Initialize( void )
   if((status = Adrv9001_GetVersionInfo( &VerInfo )) != Adrv9001Status_Success)
     return status;
 
+  /* Get DMA Instances for Continuous Streaming */
+  for(adrv9001_port_t i = 0; i < Adrv9001Port_Num; i++)
+  {
+    axi_dmac_get_instance( DmaCfg.BaseAddr[i], &PhyRing[i].Dma );
+
+    /* Driver callback, restored whenever a continuous stream ends */
+    if( PhyRing[i].Dma != NULL )
+    {
+      PhyRing[i].DrvCallback = PhyRing[i].Dma->Callback;
+      PhyRing[i].DrvCallbackRef = PhyRing[i].Dma->CallbackRef;
+    }
+  }
+
   printf("%s Successfully Initialized\r\n","ADRV9002");
   printf("  -Silicon Version: %X%X\r\n",VerInfo.Silicon.major, VerInfo.Silicon.minor);
   printf("  -Firmware Version: %u.%u.%u.%u\r\n",VerInfo.Arm.major, VerInfo.Arm.minor, VerInfo.Arm.maint, VerInfo.Arm.rcVer);
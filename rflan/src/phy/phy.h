@@ -53,6 +53,10 @@
 
 #define PHY_IS_PORT_TX(p)           ADRV9001_IS_PORT_TX(p)
 #define PHY_IS_PORT_RX(p)           ADRV9001_IS_PORT_RX(p)
+#define PHY_PORT_MASK(p)            (1 << (p))    ///< Port bit for Phy_IqStreamGroupEnable
+
+#define PHY_STREAM_BLOCK_MAX        (32)      ///< Maximum number of blocks in a continuous stream
+#define PHY_STATS_HIST_BINS         (16)      ///< Number of latency histogram bins
 
 /**
 **  ADRV9001 Status
@@ -69,6 +73,9 @@ typedef enum
   PhyStatus_Adrv9001Error       = (PHY_STATUS_OFFSET - 7),
   PhyStatus_RadioStateError     = (PHY_STATUS_OFFSET - 8),
   PhyStatus_IqStreamAbort       = (PHY_STATUS_OFFSET - 9),
+  PhyStatus_StreamPoolEmpty     = (PHY_STATUS_OFFSET - 10),
+  PhyStatus_StreamLate          = (PHY_STATUS_OFFSET - 11),
+  PhyStatus_DmaError            = (PHY_STATUS_OFFSET - 12),
 } phy_status_t;
 
 /**
@@ -88,6 +95,11 @@ typedef union
     uint32_t              SampleCnt;    ///< Length in samples
     phy_status_t          Status;       ///< Status
     void                 *CallbackRef;  ///< User Data
+    uint32_t              BlockIdx;     ///< Block sequence number of a continuous stream
+    uint32_t              OverrunCnt;   ///< Number of DMA overruns (Rx) or underruns (Tx) of a continuous stream
+    uint64_t              StartTimestamp; ///< Timestamp of first sample, see Phy_IqStreamEnable
+    uint64_t              EndTimestamp;   ///< Timestamp of last sample, see Phy_IqStreamEnable
+    uint64_t              GroupSkew;      ///< Spread of DMA start of transfer times within a stream group
   }Stream;
 
 } phy_evt_data_t;
@@ -101,6 +113,7 @@ typedef enum
   PhyEvtType_StreamDone       = 0,    ///< Indicates stream is done. EvtData = phy_stream_t
   PhyEvtType_StreamStart      = 1,    ///< Indicates stream has started. EvtData = phy_stream_t
   PhyEvtType_ProfileUpdated   = 2,    ///< Indicates profile has been updated. No Evt data
+  PhyEvtType_BlockReady       = 3,    ///< Indicates a block of a continuous stream is ready. EvtData = phy_stream_t
 } phy_evt_type_t;
 
 /**
@@ -119,8 +132,59 @@ typedef struct{
   void             *CallbackRef;      ///< User Data
   phy_status_t      Status;           ///< Status
   bool              Cyclic;           ///< Flag indicates the stream will continue Indefinitely
+  uint32_t          BlockCnt;         ///< Number of SampleCnt blocks within SampleBuf for continuous streaming, 0 = disabled
+  uint64_t          StartTime;        ///< Timestamp to start streaming, 0 = start immediately
+  uint32_t          RowSampleCnt;     ///< Samples per row of a strided stream, 0 = contiguous
+  uint32_t          RowStride;        ///< Samples from the start of one row to the next
+  uint32_t          BlocksPerIrq;     ///< Blocks completed per DMA interrupt of a continuous stream, 0 = SOT and EOT per block
 }phy_stream_t;
 
+/**
+**  PHY Stream Pool Statistics
+*/
+typedef struct{
+  uint32_t          AllocCnt;         ///< Number of stream slots taken from the pool
+  uint32_t          FreeCnt;          ///< Number of stream slots returned to the pool
+  uint32_t          ExhaustedCnt;     ///< Number of streams rejected because the pool was empty
+  uint32_t          InUse;            ///< Number of stream slots currently in use
+  uint32_t          HighWater;        ///< Maximum number of stream slots in use
+}phy_stream_pool_stats_t;
+
+/**
+**  PHY Latency Histogram
+**
+**  Bin 0 counts values under 1us, bin n counts values of 2^(n-1)us up to
+**  2^n us and the last bin also counts everything larger.
+*/
+typedef struct{
+  uint32_t          Bin[PHY_STATS_HIST_BINS]; ///< Number of values in each bin
+  uint32_t          MaxUs;                    ///< Largest value in microseconds
+}phy_hist_t;
+
+/**
+**  PHY Port Statistics
+*/
+typedef struct{
+  uint32_t          StartCnt;         ///< Streams started
+  uint32_t          CompleteCnt;      ///< Streams completed
+  uint32_t          AbortCnt;         ///< Streams aborted with Phy_IqStreamDisable
+  uint32_t          ErrorCnt;         ///< Streams ended by an error
+  uint32_t          IsrCnt;           ///< ADRV9001 stream events received
+  uint64_t          ByteCnt;          ///< Bytes moved by completed streams and blocks
+  uint32_t          OverrunCnt;       ///< Receive DMA overruns
+  uint32_t          UnderrunCnt;      ///< Transmit DMA underruns
+  phy_hist_t        IsrLatency;       ///< DMA end of transfer to PHY task
+  phy_hist_t        EnableTime;       ///< Enable request to RF on
+}phy_port_stats_t;
+
+/**
+**  PHY Statistics
+*/
+typedef struct{
+  phy_port_stats_t  Port[Adrv9001Port_Num];   ///< Per port statistics
+  uint32_t          QueueHighWater;           ///< Maximum number of messages in the PHY queue
+}phy_stats_t;
+
 /*******************************************************************************
 *
 * \details
@@ -129,8 +193,12 @@ typedef struct{
 *
 * \param[in]  Stream is the stream configuration.  This parameter is provided
 *             by the caller and can be released once the function is returned.
-*             However some of the parameters making up this variable must be
-*             maintained in memory for parts or the duration the stream.
+*             The configuration is copied into one of PHY_STREAM_POOL_SIZE
+*             statically allocated slots for the port which is owned by the
+*             PHY until the stream is removed.  PhyStatus_StreamPoolEmpty is
+*             returned if all slots for the port are in use.  However some of
+*             the parameters making up this variable must be maintained in
+*             memory for parts or the duration the stream.
 *
 *             All streams are non-blocking.  The caller will receive event
 *             callbacks indicating when the stream starts, stops, there is an
@@ -156,12 +224,124 @@ typedef struct{
 *             Once SampleCnt number of samples have been streamed to memory
 *             the user will receive a callback .
 *
+*            -Continuous Receive Stream
+*             If BlockCnt is non zero SampleBuf is treated as BlockCnt blocks of
+*             SampleCnt samples each.  The blocks are queued to the DMA in turn
+*             so that streaming continues without gaps until the caller
+*             executes Phy_IqStreamDisable.  The caller receives a callback of
+*             PhyEvtType_BlockReady for every filled block and owns that block
+*             until it is handed back with Phy_IqStreamBlockRelease.  If the
+*             DMA runs out of released blocks samples are dropped and the
+*             OverrunCnt reported with each event is incremented.
+*
+*            -Continuous Transmit Stream
+*             Transmit ports stream blocks the same way.  The caller fills all
+*             BlockCnt blocks before enabling, PhyEvtType_BlockReady indicates
+*             a block has been transmitted and may be refilled, and
+*             Phy_IqStreamBlockRelease queues the refilled block.  If the DMA
+*             runs out of released blocks the transmitter underruns and
+*             OverrunCnt is incremented.
+*
+*            -Timestamps
+*             Stream events carry timestamps in TIMESTAMP_FREQ_HZ ticks of
+*             Timestamp_Get.  PhyEvtType_StreamStart reports the DMA start of
+*             transfer time, or the time the DMA was armed if it has not
+*             started within PHY_STREAM_SPIN_US.  PhyEvtType_StreamDone reports the DMA start and end
+*             of transfer interrupt times.  PhyEvtType_BlockReady reports the
+*             DMA end of transfer time of the block and of the previous block,
+*             or the enable time for the first block.  Start times of blocks
+*             following an overrun are not exact.
+*
+*            -Timed Stream
+*             If StartTime is non zero the port is primed when the request is
+*             processed.  RF is enabled ahead of StartTime by a lead of
+*             PHY_STREAM_START_LEAD_US, or by the largest EnableTime of the
+*             port if that is longer, and only the DMA is started once
+*             Timestamp_Get reaches StartTime.  The PHY task sleeps until
+*             PHY_STREAM_SPIN_US before the start time and then spins.  The
+*             sleep ends up to two ticks early, so the spin lasts up to
+*             PHY_STREAM_SPIN_US plus two ticks and no other PHY request is
+*             processed meanwhile.  The StartTimestamp of
+*             PhyEvtType_StreamStart less StartTime gives the lateness of the
+*             start.  If the enable time has already passed once the port is
+*             primed, or is before time 0, or the enable runs past StartTime,
+*             the stream is aborted with PhyStatus_StreamLate.
+*
+*            -Strided Stream
+*             If RowSampleCnt is non zero the DMA writes or reads SampleCnt
+*             samples as rows of RowSampleCnt samples, each starting RowStride
+*             samples after the previous one.  Two receive ports started with
+*             Phy_IqStreamGroupEnable on the same buffer, the second offset by
+*             RowSampleCnt and both with RowStride of twice RowSampleCnt,
+*             produce interleaved rows with no copy.  SampleCnt must be a
+*             multiple of RowSampleCnt and rows must be a multiple of
+*             IQ_BUF_ALIGN bytes.  Blocks of a continuous stream are spaced by
+*             their number of rows times RowStride.  A single shot bypasses the
+*             ADRV9001 driver staging buffer and is moved by the DMA as one 2D
+*             transfer straight to or from SampleBuf.  Requires a DMA built
+*             with 2D transfer support and a stream that is not cyclic,
+*             otherwise PhyStatus_NotSupported.
+*
+*            -Interrupt Coalescing
+*             If BlocksPerIrq is non zero a continuous stream only takes the
+*             DMA end of transfer interrupt and up to BlocksPerIrq blocks that
+*             are adjacent in SampleBuf are moved by one DMA transfer, so the
+*             interrupt rate falls by that factor for the same block size.
+*             Blocks of a batch are delivered together and share the end of
+*             transfer timestamp of the last.  BlocksPerIrq may be at most
+*             half of BlockCnt.  Strided blocks are not merged.
+*
 *
 * \return     Status
 *
 *******************************************************************************/
 phy_status_t Phy_IqStreamEnable( phy_stream_t *Stream );
 
+/*******************************************************************************
+*
+* \details
+*
+* This function enables streaming on several ports with the least software
+* delay between them.  All ports are primed and enabled first, the enables
+* being serial Adrv9001_ToRfEnabled mailbox commands of about a millisecond
+* each, and the DMAs are then armed back to back so only the arming remains
+* between ports.  The ports still do not start on the same sample and the
+* offset is not repeatable, captures that need sample alignment must align
+* the data afterwards, for example by correlation.  Each port receives its
+* own PhyEvtType_StreamStart event with its DMA start of transfer time in
+* StartTimestamp and the spread of those times in GroupSkew.  The start of
+* transfer interrupt of a port is waited for up to PHY_STREAM_SPIN_US, after
+* which its arm time is used.  If any port fails the whole group is aborted.
+* Streams behave as described for Phy_IqStreamEnable once started and are
+* disabled individually with Phy_IqStreamDisable.  Timed streams are not
+* supported.
+*
+* \param[in]  PortMask is the set of ports built with PHY_PORT_MASK
+*
+* \param[in]  Streams is indexed by port, only ports in PortMask are used
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t Phy_IqStreamGroupEnable( uint32_t PortMask, phy_stream_t *Streams[] );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function returns ownership of a block of a continuous stream back to the
+* PHY so it can be queued to the DMA again.
+*
+* \param[in]  Port is the port of the continuous stream
+*
+* \param[in]  Block is the SampleBuf provided with the PhyEvtType_BlockReady
+*             event
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t Phy_IqStreamBlockRelease( adrv9001_port_t Port, uint32_t *Block );
+
 /*******************************************************************************
 *
 * \details
@@ -175,6 +355,45 @@ phy_status_t Phy_IqStreamEnable( phy_stream_t *Stream );
 *******************************************************************************/
 phy_status_t Phy_IqStreamDisable( adrv9001_port_t Port );
 
+/*******************************************************************************
+*
+* \details
+*
+* This function returns the stream slot pool statistics for a port.
+*
+* \param[in]  Port is the port being requested
+*
+* \param[out] Stats is the returned statistics
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t Phy_GetStreamPoolStats( adrv9001_port_t Port, phy_stream_pool_stats_t *Stats );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function returns the PHY performance counters and latency histograms.
+*
+* \param[out] Stats is the statistics
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t Phy_GetStats( phy_stats_t *Stats );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function clears the PHY performance counters and latency histograms.
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t Phy_ClearStats( void );
+
 /*******************************************************************************
 *
 * \details
@@ -47,8 +47,13 @@
 #include "phy_cli.h"
 #include "app_cli.h"
 #include "phy.h"
+#include "phy_record.h"
+#include "phy_playback.h"
+#include "phy_trigger.h"
 #include "parameters.h"
 #include "iq_file.h"
+#include "iq_buf.h"
+#include "timestamp.h"
 
 
 static const char* PhyCli_ParsePort(const char *cmd, uint16_t pNum, adrv9001_port_t *port)
@@ -79,7 +84,7 @@ static const char* PhyCli_ParsePort(const char *cmd, uint16_t pNum, adrv9001_por
 *******************************************************************************/
 static void PhyCli_UpdateProfile(Cli_t *CliInstance, const char *cmd, void *userData)
 {
-  char *filename = calloc(1, FF_FILENAME_MAX_LEN );
+  char filename[FF_FILENAME_MAX_LEN];
   strcpy(filename,FF_LOGICAL_DRIVE_PATH);
   Cli_GetParameter(cmd, 1, CliParamTypeStr, &filename[strlen(filename)]);
 
@@ -106,7 +111,7 @@ static void PhyCli_UpdateProfile(Cli_t *CliInstance, const char *cmd, void *user
   }
 
   /* Allocate Memory */
-  if((Buf = malloc( ADRV9001_PROFILE_SIZE )) == NULL)
+  if((Buf = IqBuf_Alloc( ADRV9001_PROFILE_SIZE )) == NULL)
   {
     printf("Insufficient Memory\r\n");
     f_close( &fil );
@@ -120,7 +125,7 @@ static void PhyCli_UpdateProfile(Cli_t *CliInstance, const char *cmd, void *user
   if(f_read(&fil, Buf, length, &length) != FR_OK)
   {
     printf("Read File Error\r\n");
-    free( Buf );
+    IqBuf_Free( Buf );
     f_close( &fil );
     return;
   }
@@ -139,7 +144,7 @@ static void PhyCli_UpdateProfile(Cli_t *CliInstance, const char *cmd, void *user
   }
 
   /* Free Memory */
-  free( Buf );
+  IqBuf_Free( Buf );
 
 }
 
@@ -160,34 +165,123 @@ static const CliCmd_t PhyCliUpdateProfileDef =
 *******************************************************************************/
 #define PHY_STREAM_RX_SAMPLE_CNT          (16384)
 
+/**
+**  PHY CLI Stream Context
+*/
+typedef struct phy_cli_stream
+{
+  volatile bool     InUse;                            ///< Context is allocated
+  char              Filename[FF_FILENAME_MAX_LEN];    ///< Stream filename
+  struct phy_cli_stream *Peer;                        ///< Stream sharing the sample buffer, NULL = none
+  uint32_t         *SharedBuf;                        ///< Buffer written once this stream and its peer are done
+  uint32_t          SharedCnt;                        ///< Samples in SharedBuf
+  bool              Done;                             ///< Stream is done and waiting for its peer
+  uint32_t         *WriteBuf;                         ///< Buffer being written to Filename
+} phy_cli_stream_t;
+
+static phy_cli_stream_t PhyCliStream[Adrv9001Port_Num][PHY_STREAM_POOL_SIZE];
+
+static phy_cli_stream_t *PhyCli_StreamAlloc( adrv9001_port_t Port )
+{
+  for( int i = 0; i < PHY_STREAM_POOL_SIZE; i++ )
+  {
+    if( !PhyCliStream[Port][i].InUse )
+    {
+      PhyCliStream[Port][i].InUse = true;
+      PhyCliStream[Port][i].Peer = NULL;
+      PhyCliStream[Port][i].SharedBuf = NULL;
+      PhyCliStream[Port][i].Done = false;
+      return &PhyCliStream[Port][i];
+    }
+  }
+
+  return NULL;
+}
+
+static void PhyCli_GetFileMeta( adrv9001_port_t Port, uint64_t StartTimestamp, iq_file_meta_t *Meta )
+{
+  *Meta = (iq_file_meta_t){ .Port = Port, .StartTimestamp = StartTimestamp };
+
+  /* Unknown values are left at zero */
+  Adrv9001_GetSampleRate( Port, &Meta->SampleRate );
+  Adrv9001_GetCarrierFrequency( Port, &Meta->CarrierFreq );
+  Meta->TemperatureValid = (Adrv9001_GetTemperature( &Meta->Temperature ) == Adrv9001Status_Success);
+}
+
+static void PhyCli_SaveFileDone( int32_t Status, void *CallbackRef )
+{
+  phy_cli_stream_t *Ctx = (phy_cli_stream_t*)CallbackRef;
+
+  if( Status != XST_SUCCESS )
+    printf("%s write error\r\n", Ctx->Filename);
+
+  /* Free Sample Buffer */
+  IqBuf_Free(Ctx->WriteBuf);
+
+  /* Release Stream Contexts */
+  if( Ctx->Peer != NULL )
+    Ctx->Peer->InUse = false;
+
+  Ctx->InUse = false;
+}
+
+/* Write received samples to the stream file.  The file is written by the IQ
+   file task so the PHY task is not held up by the SD card, the context and
+   buffer are released once the file is closed. */
+static void PhyCli_SaveFile( phy_cli_stream_t *Ctx, uint32_t *Buf, uint32_t SampleCnt, adrv9001_port_t Port, uint64_t StartTimestamp )
+{
+  iq_file_meta_t Meta;
+
+  PhyCli_GetFileMeta( Port, StartTimestamp, &Meta );
+
+  Ctx->WriteBuf = Buf;
+
+  if( IqFile_WriteAsync( Ctx->Filename, Buf, SampleCnt, &Meta, PhyCli_SaveFileDone, Ctx ) != XST_SUCCESS )
+    PhyCli_SaveFileDone( IqFile_Write( Ctx->Filename, Buf, SampleCnt, &Meta ), Ctx );
+}
+
 static void PhyCli_PhyCallback( phy_evt_type_t EvtType, phy_evt_data_t EvtData, void *param)
 {
+  phy_cli_stream_t *Ctx = (phy_cli_stream_t*)EvtData.Stream.CallbackRef;
+
   if( EvtType == PhyEvtType_StreamDone )
   {
     /* Indicate Event to User */
-    printf("%s stream done\r\n", ADRV9001_PORT_2_STR( EvtData.Stream.Port ));
+    printf("%s stream done %lluus\r\n", ADRV9001_PORT_2_STR( EvtData.Stream.Port ),
+        Timestamp_ToUs( EvtData.Stream.EndTimestamp - EvtData.Stream.StartTimestamp ));
 
-    /* Process Rx Stream */
-    if( PHY_IS_PORT_RX( EvtData.Stream.Port ) )
+    /* Shared buffer is written once both streams are done */
+    if( Ctx->Peer != NULL )
     {
-      /* Delete Existing File */
-      f_unlink(EvtData.Stream.CallbackRef);
+      Ctx->Done = true;
 
-      /* Write To File */
-      if( IqFile_Write(EvtData.Stream.CallbackRef, EvtData.Stream.SampleBuf, EvtData.Stream.SampleCnt) != XST_SUCCESS)
-        printf("%s stream file write error\r\n", ADRV9001_PORT_2_STR( EvtData.Stream.Port ));
+      if( !Ctx->Peer->Done )
+        return;
 
-      /* Free Filename */
-      free(EvtData.Stream.CallbackRef);
+      PhyCli_SaveFile( Ctx, Ctx->SharedBuf, Ctx->SharedCnt, EvtData.Stream.Port, EvtData.Stream.StartTimestamp );
+      return;
+    }
+
+    /* Process Rx Stream */
+    if( PHY_IS_PORT_RX( EvtData.Stream.Port ) )
+    {
+      PhyCli_SaveFile( Ctx, EvtData.Stream.SampleBuf, EvtData.Stream.SampleCnt, EvtData.Stream.Port, EvtData.Stream.StartTimestamp );
+      return;
     }
 
     /* Free Sample Buffer */
-    free(EvtData.Stream.SampleBuf);
+    IqBuf_Free(EvtData.Stream.SampleBuf);
+
+    /* Release Stream Context */
+    Ctx->InUse = false;
   }
   else if( EvtType == PhyEvtType_StreamStart )
   {
     /* Indicate Event to User */
-    printf("%s stream start\r\n", ADRV9001_PORT_2_STR( EvtData.Stream.Port ));
+    if( EvtData.Stream.GroupSkew > 0 )
+      printf("%s stream start, group skew %lluus\r\n", ADRV9001_PORT_2_STR( EvtData.Stream.Port ), Timestamp_ToUs( EvtData.Stream.GroupSkew ));
+    else
+      printf("%s stream start\r\n", ADRV9001_PORT_2_STR( EvtData.Stream.Port ));
   }
   else if( EvtType == PhyEvtType_ProfileUpdated )
   {
@@ -212,8 +306,19 @@ static void PhyCli_IqFileStreamEnable(Cli_t *CliInstance, const char *cmd, void
     return;
   }
 
+  /* Take Stream Context */
+  phy_cli_stream_t *Ctx = PhyCli_StreamAlloc( Stream.Port );
+
+  if( Ctx == NULL )
+  {
+    printf("Busy\r\n");
+    return;
+  }
+
+  Stream.CallbackRef = Ctx;
+
   /* Get Filename */
-  char *filename = calloc(1, FF_FILENAME_MAX_LEN );
+  char *filename = Ctx->Filename;
   strcpy(filename,FF_LOGICAL_DRIVE_PATH);
   Cli_GetParameter(cmd, 2, CliParamTypeStr, &filename[strlen(filename)]);
 
@@ -230,9 +335,10 @@ static void PhyCli_IqFileStreamEnable(Cli_t *CliInstance, const char *cmd, void
 
   if( (Stream.Port == Adrv9001Port_Tx1) || (Stream.Port == Adrv9001Port_Tx2) )
   {
-    if(IqFile_Read( filename, &Stream.SampleBuf, &Stream.SampleCnt ) != XST_SUCCESS)
+    if(IqFile_Read( filename, &Stream.SampleBuf, &Stream.SampleCnt, NULL ) != XST_SUCCESS)
     {
       printf("Invalid Parameter\r\n");
+      Ctx->InUse = false;
       return;
     }
 
@@ -244,35 +350,323 @@ static void PhyCli_IqFileStreamEnable(Cli_t *CliInstance, const char *cmd, void
     if( SampleCnt <= 0 )
     {
       printf("Invalid Parameter. Sample Count must be greater than zero for receive\r\n");
+      Ctx->InUse = false;
       return;
     }
 
     Stream.SampleCnt = SampleCnt;
 
-    /* Store Filename for future reference */
-    if((Stream.CallbackRef = malloc(strlen(filename))) == NULL)
+    /* Allocate Buffer */
+    if((Stream.SampleBuf = IqBuf_Alloc(SampleCnt * sizeof(uint32_t))) == NULL)
     {
       printf("Memory Error\r\n");
+      Ctx->InUse = false;
       return;
     }
-    else
+  }
+
+  /* Enable Streaming */
+  if(Phy_IqStreamEnable( &Stream ) != PhyStatus_Success)
+  {
+    printf("Failed\r\n");
+    IqBuf_Free(Stream.SampleBuf);
+    Ctx->InUse = false;
+  }
+}
+
+static void PhyCli_IqFileRxGroup(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  phy_stream_t Rx[2] = {{.Port = Adrv9001Port_Rx1, .Callback = PhyCli_PhyCallback},
+                        {.Port = Adrv9001Port_Rx2, .Callback = PhyCli_PhyCallback}};
+  phy_stream_t *Streams[Adrv9001Port_Num] = {&Rx[0], &Rx[1], NULL, NULL};
+  phy_cli_stream_t *Ctx[2];
+
+  int32_t SampleCnt;
+  Cli_GetParameter(cmd, 3, CliParamTypeS32, &SampleCnt);
+
+  if( SampleCnt <= 0 )
+  {
+    printf("Invalid Parameter. Sample Count must be greater than zero for receive\r\n");
+    return;
+  }
+
+  Adrv9001_ClearError( );
+
+  for( int i = 0; i < 2; i++ )
+  {
+    /* Take Stream Context */
+    if((Ctx[i] = PhyCli_StreamAlloc( Rx[i].Port )) == NULL)
     {
-      strcpy((char*)Stream.CallbackRef, filename);
+      printf("Busy\r\n");
+      break;
     }
 
+    Rx[i].CallbackRef = Ctx[i];
+    Rx[i].SampleCnt = SampleCnt;
+
+    /* Get Filename */
+    strcpy(Ctx[i]->Filename,FF_LOGICAL_DRIVE_PATH);
+    Cli_GetParameter(cmd, i + 1, CliParamTypeStr, &Ctx[i]->Filename[strlen(Ctx[i]->Filename)]);
+
     /* Allocate Buffer */
-    if((Stream.SampleBuf = calloc(1, SampleCnt * sizeof(uint32_t))) == NULL)
+    if((Rx[i].SampleBuf = IqBuf_Alloc(SampleCnt * sizeof(uint32_t))) == NULL)
     {
       printf("Memory Error\r\n");
-      return;
+      Ctx[i]->InUse = false;
+      Ctx[i] = NULL;
+      break;
     }
   }
 
   /* Enable Streaming */
-  if(Phy_IqStreamEnable( &Stream ) != PhyStatus_Success)
+  if( (Rx[1].SampleBuf == NULL) ||
+      (Phy_IqStreamGroupEnable( PHY_PORT_MASK(Adrv9001Port_Rx1) | PHY_PORT_MASK(Adrv9001Port_Rx2), Streams ) != PhyStatus_Success) )
+  {
+    printf("Failed\r\n");
+
+    for( int i = 0; i < 2; i++ )
+    {
+      IqBuf_Free(Rx[i].SampleBuf);
+
+      if( Rx[i].CallbackRef != NULL )
+        ((phy_cli_stream_t*)Rx[i].CallbackRef)->InUse = false;
+    }
+  }
+}
+
+static void PhyCli_IqFileRxShared(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  phy_stream_t Rx[2] = {{.Port = Adrv9001Port_Rx1, .Callback = PhyCli_PhyCallback},
+                        {.Port = Adrv9001Port_Rx2, .Callback = PhyCli_PhyCallback}};
+  phy_stream_t *Streams[Adrv9001Port_Num] = {&Rx[0], &Rx[1], NULL, NULL};
+  phy_cli_stream_t *Ctx[2] = {NULL, NULL};
+  uint32_t *Buf;
+
+  int32_t SampleCnt;
+  Cli_GetParameter(cmd, 2, CliParamTypeS32, &SampleCnt);
+
+  int32_t RowSampleCnt;
+  Cli_GetParameter(cmd, 3, CliParamTypeS32, &RowSampleCnt);
+
+  if( (SampleCnt <= 0) || (RowSampleCnt < 0) )
+  {
+    printf("Invalid Parameter\r\n");
+    return;
+  }
+
+  Adrv9001_ClearError( );
+
+  /* Take Stream Contexts */
+  Ctx[0] = PhyCli_StreamAlloc( Adrv9001Port_Rx1 );
+  Ctx[1] = PhyCli_StreamAlloc( Adrv9001Port_Rx2 );
+
+  if( (Ctx[0] == NULL) || (Ctx[1] == NULL) )
+  {
+    printf("Busy\r\n");
+  }
+  else if((Buf = IqBuf_Alloc(2 * SampleCnt * sizeof(uint32_t))) == NULL)
+  {
+    printf("Memory Error\r\n");
+  }
+  else
+  {
+    /* Rx1 rows are followed by Rx2 rows, or Rx2 follows all of Rx1 */
+    for( int i = 0; i < 2; i++ )
+    {
+      Rx[i].SampleCnt = SampleCnt;
+      Rx[i].RowSampleCnt = RowSampleCnt;
+      Rx[i].RowStride = 2 * RowSampleCnt;
+      Rx[i].SampleBuf = &Buf[ i * ((RowSampleCnt > 0) ? RowSampleCnt : SampleCnt) ];
+      Rx[i].CallbackRef = Ctx[i];
+
+      Ctx[i]->Peer = Ctx[1 - i];
+      Ctx[i]->SharedBuf = Buf;
+      Ctx[i]->SharedCnt = 2 * SampleCnt;
+    }
+
+    strcpy(Ctx[1]->Filename,FF_LOGICAL_DRIVE_PATH);
+    Cli_GetParameter(cmd, 1, CliParamTypeStr, &Ctx[1]->Filename[strlen(Ctx[1]->Filename)]);
+    strcpy(Ctx[0]->Filename,Ctx[1]->Filename);
+
+    /* Enable Streaming */
+    if( Phy_IqStreamGroupEnable( PHY_PORT_MASK(Adrv9001Port_Rx1) | PHY_PORT_MASK(Adrv9001Port_Rx2), Streams ) == PhyStatus_Success )
+      return;
+
+    printf("Failed\r\n");
+    IqBuf_Free(Buf);
+  }
+
+  for( int i = 0; i < 2; i++ )
+  {
+    if( Ctx[i] != NULL )
+      Ctx[i]->InUse = false;
+  }
+}
+
+static void PhyCli_Record(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  adrv9001_port_t Port;
+  char filename[FF_FILENAME_MAX_LEN];
+  uint64_t SampleCnt;
+
+  /* Parse Port */
+  if(PhyCli_ParsePort(cmd, 1, &Port) == NULL)
+  {
+    printf("Invalid Parameter\r\n");
+    return;
+  }
+
+  /* Get Filename */
+  strcpy(filename,FF_LOGICAL_DRIVE_PATH);
+  Cli_GetParameter(cmd, 2, CliParamTypeStr, &filename[strlen(filename)]);
+
+  Cli_GetParameter(cmd, 3, CliParamTypeU64, &SampleCnt);
+
+  if(PhyRecord_Start( Port, filename, SampleCnt ) != PhyStatus_Success)
+  {
+    printf("Failed\r\n");
+  }
+}
+
+static void PhyCli_RecordStop(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  if(PhyRecord_Stop( ) != PhyStatus_Success)
+  {
+    printf("Failed\r\n");
+  }
+}
+
+static void PhyCli_RecordStats(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  phy_record_stats_t Stats;
+
+  if(PhyRecord_GetStats( &Stats ) != PhyStatus_Success)
   {
     printf("Failed\r\n");
+    return;
   }
+
+  printf("Active:         %s\r\n", Stats.Active ? "Yes" : "No");
+  printf("Samples:        %llu\r\n", Stats.SampleCnt);
+  printf("Blocks:         %lu\r\n", Stats.BlockCnt);
+  printf("Overruns:       %lu\r\n", Stats.OverrunCnt);
+  printf("Write Errors:   %lu\r\n", Stats.WriteErrCnt);
+  printf("Queue Max:      %lu\r\n", Stats.QueueHighWater);
+  printf("Write Time:     %lluus\r\n", Timestamp_ToUs( Stats.WriteTime ));
+  printf("Write Max:      %lluus\r\n", Timestamp_ToUs( Stats.WriteTimeMax ));
+  printf("Stall Time:     %lluus\r\n", Timestamp_ToUs( Stats.StallTime ));
+}
+
+static void PhyCli_Playback(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  adrv9001_port_t Port;
+  char filename[FF_FILENAME_MAX_LEN];
+  uint8_t Loop;
+
+  /* Parse Port */
+  if(PhyCli_ParsePort(cmd, 1, &Port) == NULL)
+  {
+    printf("Invalid Parameter\r\n");
+    return;
+  }
+
+  /* Get Filename */
+  strcpy(filename,FF_LOGICAL_DRIVE_PATH);
+  Cli_GetParameter(cmd, 2, CliParamTypeStr, &filename[strlen(filename)]);
+
+  Cli_GetParameter(cmd, 3, CliParamTypeU8, &Loop);
+
+  if(PhyPlayback_Start( Port, filename, Loop != 0 ) != PhyStatus_Success)
+  {
+    printf("Failed\r\n");
+  }
+}
+
+static void PhyCli_PlaybackStop(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  if(PhyPlayback_Stop( ) != PhyStatus_Success)
+  {
+    printf("Failed\r\n");
+  }
+}
+
+static void PhyCli_PlaybackStats(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  phy_playback_stats_t Stats;
+
+  if(PhyPlayback_GetStats( &Stats ) != PhyStatus_Success)
+  {
+    printf("Failed\r\n");
+    return;
+  }
+
+  printf("Active:         %s\r\n", Stats.Active ? "Yes" : "No");
+  printf("Samples:        %llu\r\n", Stats.SampleCnt);
+  printf("Blocks:         %lu\r\n", Stats.BlockCnt);
+  printf("Loops:          %lu\r\n", Stats.LoopCnt);
+  printf("Underruns:      %lu\r\n", Stats.UnderrunCnt);
+  printf("Read Errors:    %lu\r\n", Stats.ReadErrCnt);
+  printf("Read Max:       %lluus\r\n", Timestamp_ToUs( Stats.ReadTimeMax ));
+}
+
+static void PhyCli_Trigger(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  phy_trigger_cfg_t Cfg;
+  char filename[FF_FILENAME_MAX_LEN];
+  uint8_t Mode;
+
+  /* Parse Port */
+  if(PhyCli_ParsePort(cmd, 1, &Cfg.Port) == NULL)
+  {
+    printf("Invalid Parameter\r\n");
+    return;
+  }
+
+  /* Get Filename */
+  strcpy(filename,FF_LOGICAL_DRIVE_PATH);
+  Cli_GetParameter(cmd, 2, CliParamTypeStr, &filename[strlen(filename)]);
+  Cfg.Filename = filename;
+
+  Cli_GetParameter(cmd, 3, CliParamTypeU8, &Mode);
+  Cli_GetParameter(cmd, 4, CliParamTypeU32, &Cfg.Threshold);
+  Cli_GetParameter(cmd, 5, CliParamTypeU32, &Cfg.PreBlockCnt);
+  Cli_GetParameter(cmd, 6, CliParamTypeU32, &Cfg.PostBlockCnt);
+
+  Cfg.Mode = (Mode == 0) ? PhyTriggerMode_Mean : PhyTriggerMode_Peak;
+
+  if(PhyTrigger_Start( &Cfg ) != PhyStatus_Success)
+  {
+    printf("Failed\r\n");
+  }
+}
+
+static void PhyCli_TriggerStop(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  if(PhyTrigger_Stop( ) != PhyStatus_Success)
+  {
+    printf("Failed\r\n");
+  }
+}
+
+static void PhyCli_TriggerStats(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  phy_trigger_stats_t Stats;
+  const char *State[] = {"Idle", "Armed", "Capturing", "Writing"};
+
+  if(PhyTrigger_GetStats( &Stats ) != PhyStatus_Success)
+  {
+    printf("Failed\r\n");
+    return;
+  }
+
+  printf("State:          %s\r\n", State[Stats.State]);
+  printf("Triggered:      %s\r\n", Stats.Triggered ? "Yes" : "No");
+  printf("Blocks:         %lu\r\n", Stats.BlockCnt);
+  printf("Overruns:       %lu\r\n", Stats.OverrunCnt);
+  printf("Write Errors:   %lu\r\n", Stats.WriteErrCnt);
+  printf("Trigger Mean:   %lu\r\n", Stats.TriggerMean);
+  printf("Trigger Peak:   %lu\r\n", Stats.TriggerPeak);
+  printf("Trigger Time:   %lluus\r\n", Timestamp_ToUs( Stats.TriggerTimestamp ));
 }
 
 static void PhyCli_IqFileStreamDisable(Cli_t *CliInstance, const char *cmd, void *userData)
@@ -298,7 +692,7 @@ static void PhyCli_IqFileSize(Cli_t *CliInstance, const char *cmd, void *userDat
   int32_t status;
 
   /* Get Filename */
-  char *filename = calloc(1, FF_FILENAME_MAX_LEN );
+  char filename[FF_FILENAME_MAX_LEN];
   strcpy(filename,FF_LOGICAL_DRIVE_PATH);
   Cli_GetParameter(cmd, 1, CliParamTypeStr, &filename[strlen(filename)]);
 
@@ -307,7 +701,10 @@ static void PhyCli_IqFileSize(Cli_t *CliInstance, const char *cmd, void *userDat
 
   if((status = f_open(&fil, filename, FA_OPEN_EXISTING | FA_READ)) == FR_OK)
   {
-    status = IqFile_GetSampleCnt( &fil, &SampleCnt);
+    if( IqFile_IsSigMF( filename ) )
+      SampleCnt = (uint32_t)(f_size(&fil) / sizeof(uint32_t));
+    else
+      status = IqFile_GetSampleCnt( &fil, &SampleCnt);
   }
 
   f_close(&fil);
@@ -322,10 +719,80 @@ static void PhyCli_IqFileSize(Cli_t *CliInstance, const char *cmd, void *userDat
   }
 }
 
+static void PhyCli_StreamPool(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  phy_stream_pool_stats_t Stats;
+
+  printf("Port  InUse  HighWater  Alloc       Free        Exhausted\r\n");
+
+  for( adrv9001_port_t Port = 0; Port < Adrv9001Port_Num; Port++ )
+  {
+    if( Phy_GetStreamPoolStats( Port, &Stats ) == PhyStatus_Success )
+    {
+      printf("%-6s%-7lu%-11lu%-12lu%-12lu%lu\r\n", ADRV9001_PORT_2_STR( Port ),
+          Stats.InUse, Stats.HighWater, Stats.AllocCnt, Stats.FreeCnt, Stats.ExhaustedCnt);
+    }
+  }
+}
+
+static void PhyCli_PrintHist(const char *Name, const phy_hist_t *Hist)
+{
+  printf("  %-12s", Name);
+
+  for( uint32_t i = 0; i < PHY_STATS_HIST_BINS; i++ )
+    printf("%-7lu", Hist->Bin[i]);
+
+  printf("max %luus\r\n", Hist->MaxUs);
+}
+
+static void PhyCli_Stats(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  phy_stats_t Stats;
+
+  if( Phy_GetStats( &Stats ) != PhyStatus_Success )
+    return;
+
+  printf("Port  Start    Complete Abort    Error    Isr      Overrun  Underrun Bytes\r\n");
+
+  for( adrv9001_port_t Port = 0; Port < Adrv9001Port_Num; Port++ )
+  {
+    phy_port_stats_t *p = &Stats.Port[Port];
+
+    printf("%-6s%-9lu%-9lu%-9lu%-9lu%-9lu%-9lu%-9lu%llu\r\n", ADRV9001_PORT_2_STR( Port ),
+        p->StartCnt, p->CompleteCnt, p->AbortCnt, p->ErrorCnt, p->IsrCnt,
+        p->OverrunCnt, p->UnderrunCnt, p->ByteCnt);
+  }
+
+  /* Histogram bin i counts values below 2^i microseconds */
+  printf("\r\n  %-12s", "Bin (us) <");
+  for( uint32_t i = 0; i < PHY_STATS_HIST_BINS; i++ )
+  {
+    if( i == (PHY_STATS_HIST_BINS - 1) )
+      printf("%-7s", "more");
+    else
+      printf("%-7lu", (uint32_t)1 << i);
+  }
+  printf("\r\n");
+
+  for( adrv9001_port_t Port = 0; Port < Adrv9001Port_Num; Port++ )
+  {
+    printf("%s\r\n", ADRV9001_PORT_2_STR( Port ));
+    PhyCli_PrintHist("IsrLatency", &Stats.Port[Port].IsrLatency);
+    PhyCli_PrintHist("EnableTime", &Stats.Port[Port].EnableTime);
+  }
+
+  printf("\r\nQueue High Water: %lu\r\n", Stats.QueueHighWater);
+}
+
+static void PhyCli_StatsClear(Cli_t *CliInstance, const char *cmd, void *userData)
+{
+  Phy_ClearStats( );
+}
+
 static const CliCmd_t PhyCliIqFileStreamEnableDef =
 {
   "PhyIqFileStreamEnable",
-  "PhyIqFileStreamEnable:  Enable IQ stream to or from a file. \r\n"
+  "PhyIqFileStreamEnable:  Enable IQ stream to or from a file, binary if the filename ends in " IQ_FILE_BIN_EXT ", compressed binary if it ends in " IQ_FILE_RICE_EXT ", SigMF if it ends in " IQ_FILE_SIGMF_EXT ", csv otherwise. \r\n"
   "PhyIqFileStreamEnable < port ( Rx1,Rx2,Tx1,Tx2 ), filename, SampleCnt (-1 = indefinite, 0 = file size, >0 = number of samples ) >\r\n\r\n",
   (CliCmdFn_t)PhyCli_IqFileStreamEnable,
   3,
@@ -342,6 +809,146 @@ static const CliCmd_t PhyCliIqFileStreamDisableDef =
   NULL
 };
 
+static const CliCmd_t PhyCliIqFileRxGroupDef =
+{
+  "PhyIqFileRxGroup",
+  "PhyIqFileRxGroup:  Stream Rx1 and Rx2 to files with back to back starts, reports the DMA start skew. \r\n"
+  "PhyIqFileRxGroup < rx1 filename, rx2 filename, sample count >\r\n\r\n",
+  (CliCmdFn_t)PhyCli_IqFileRxGroup,
+  3,
+  NULL
+};
+
+static const CliCmd_t PhyCliIqFileRxSharedDef =
+{
+  "PhyIqFileRxShared",
+  "PhyIqFileRxShared:  Stream Rx1 and Rx2 into one buffer and file using strided DMA. \r\n"
+  "PhyIqFileRxShared < filename, sample count per port, row samples ( 0 = Rx1 then Rx2, >0 = interleaved rows ) >\r\n\r\n",
+  (CliCmdFn_t)PhyCli_IqFileRxShared,
+  3,
+  NULL
+};
+
+static const CliCmd_t PhyCliRecordDef =
+{
+  "PhyRecord",
+  "PhyRecord:  Record a receive port to a binary file, the filename must end in " IQ_FILE_BIN_EXT " or " IQ_FILE_RICE_EXT ". \r\n"
+  "PhyRecord < port ( Rx1,Rx2 ), filename, sample count >\r\n\r\n",
+  (CliCmdFn_t)PhyCli_Record,
+  3,
+  NULL
+};
+
+static const CliCmd_t PhyCliRecordStopDef =
+{
+  "PhyRecordStop",
+  "PhyRecordStop:  Stop the active record. \r\n"
+  "PhyRecordStop < >\r\n\r\n",
+  (CliCmdFn_t)PhyCli_RecordStop,
+  0,
+  NULL
+};
+
+static const CliCmd_t PhyCliRecordStatsDef =
+{
+  "PhyRecordStats",
+  "PhyRecordStats:  Returns statistics of the active or last record. \r\n"
+  "PhyRecordStats < >\r\n\r\n",
+  (CliCmdFn_t)PhyCli_RecordStats,
+  0,
+  NULL
+};
+
+static const CliCmd_t PhyCliPlaybackDef =
+{
+  "PhyPlayback",
+  "PhyPlayback:  Play a binary file to a transmit port. \r\n"
+  "PhyPlayback < port ( Tx1,Tx2 ), filename, loop ( 0 = once, 1 = repeat ) >\r\n\r\n",
+  (CliCmdFn_t)PhyCli_Playback,
+  3,
+  NULL
+};
+
+static const CliCmd_t PhyCliPlaybackStopDef =
+{
+  "PhyPlaybackStop",
+  "PhyPlaybackStop:  Stop the active playback. \r\n"
+  "PhyPlaybackStop < >\r\n\r\n",
+  (CliCmdFn_t)PhyCli_PlaybackStop,
+  0,
+  NULL
+};
+
+static const CliCmd_t PhyCliPlaybackStatsDef =
+{
+  "PhyPlaybackStats",
+  "PhyPlaybackStats:  Returns statistics of the active or last playback. \r\n"
+  "PhyPlaybackStats < >\r\n\r\n",
+  (CliCmdFn_t)PhyCli_PlaybackStats,
+  0,
+  NULL
+};
+
+static const CliCmd_t PhyCliTriggerDef =
+{
+  "PhyTrigger",
+  "PhyTrigger:  Arm a triggered capture of a receive port to a binary file. \r\n"
+  "PhyTrigger < port ( Rx1,Rx2 ), filename, mode ( 0 = mean, 1 = peak ), threshold ( I*I + Q*Q ), pre blocks, post blocks >\r\n\r\n",
+  (CliCmdFn_t)PhyCli_Trigger,
+  6,
+  NULL
+};
+
+static const CliCmd_t PhyCliTriggerStopDef =
+{
+  "PhyTriggerStop",
+  "PhyTriggerStop:  Disarm the active triggered capture. \r\n"
+  "PhyTriggerStop < >\r\n\r\n",
+  (CliCmdFn_t)PhyCli_TriggerStop,
+  0,
+  NULL
+};
+
+static const CliCmd_t PhyCliTriggerStatsDef =
+{
+  "PhyTriggerStats",
+  "PhyTriggerStats:  Returns statistics of the active or last triggered capture. \r\n"
+  "PhyTriggerStats < >\r\n\r\n",
+  (CliCmdFn_t)PhyCli_TriggerStats,
+  0,
+  NULL
+};
+
+static const CliCmd_t PhyCliStatsDef =
+{
+  "PhyStats",
+  "PhyStats:  Returns stream counters and latency histograms \r\n"
+  "PhyStats < >\r\n\r\n",
+  (CliCmdFn_t)PhyCli_Stats,
+  0,
+  NULL
+};
+
+static const CliCmd_t PhyCliStatsClearDef =
+{
+  "PhyStatsClear",
+  "PhyStatsClear:  Clears stream counters and latency histograms \r\n"
+  "PhyStatsClear < >\r\n\r\n",
+  (CliCmdFn_t)PhyCli_StatsClear,
+  0,
+  NULL
+};
+
+static const CliCmd_t PhyCliStreamPoolDef =
+{
+  "PhyStreamPool",
+  "PhyStreamPool:  Returns stream slot pool statistics \r\n"
+  "PhyStreamPool < >\r\n\r\n",
+  (CliCmdFn_t)PhyCli_StreamPool,
+  0,
+  NULL
+};
+
 static const CliCmd_t PhyCliIqFileSizeDef =
 {
   "PhyIqFileSize",
@@ -365,7 +972,21 @@ int PhyCli_Initialize( void )
 
   Cli_RegisterCommand(Instance, &PhyCliIqFileStreamEnableDef);
   Cli_RegisterCommand(Instance, &PhyCliIqFileStreamDisableDef);
+  Cli_RegisterCommand(Instance, &PhyCliIqFileRxGroupDef);
+  Cli_RegisterCommand(Instance, &PhyCliIqFileRxSharedDef);
+  Cli_RegisterCommand(Instance, &PhyCliRecordDef);
+  Cli_RegisterCommand(Instance, &PhyCliRecordStopDef);
+  Cli_RegisterCommand(Instance, &PhyCliRecordStatsDef);
+  Cli_RegisterCommand(Instance, &PhyCliPlaybackDef);
+  Cli_RegisterCommand(Instance, &PhyCliPlaybackStopDef);
+  Cli_RegisterCommand(Instance, &PhyCliPlaybackStatsDef);
+  Cli_RegisterCommand(Instance, &PhyCliTriggerDef);
+  Cli_RegisterCommand(Instance, &PhyCliTriggerStopDef);
+  Cli_RegisterCommand(Instance, &PhyCliTriggerStatsDef);
   Cli_RegisterCommand(Instance, &PhyCliIqFileSizeDef);
+  Cli_RegisterCommand(Instance, &PhyCliStreamPoolDef);
+  Cli_RegisterCommand(Instance, &PhyCliStatsDef);
+  Cli_RegisterCommand(Instance, &PhyCliStatsClearDef);
   Cli_RegisterCommand(Instance, &PhyCliUpdateProfileDef);
 
 
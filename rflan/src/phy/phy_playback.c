@@ -0,0 +1,358 @@
+/***************************************************************************//**
+*  \addtogroup PHY_PLAYBACK
+*   @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       phy_playback.c
+*
+*  \details    This file contains the RFLAN PHY playback implementation.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "phy_playback.h"
+#include "phy.h"
+#include "parameters.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "ff.h"
+#include "iq_buf.h"
+#include "ddr_arena.h"
+#include "mem_dma.h"
+#include "timestamp.h"
+#include "iq_file.h"
+#include "xstatus.h"
+
+#define PHY_PLAYBACK_QUEUE_SIZE     (PHY_STREAM_BLOCK_MAX)    ///< Block queue size, holds every block of the stream
+#define PHY_PLAYBACK_BUF_SIZE       (PHY_PLAYBACK_BLOCK_CNT * PHY_PLAYBACK_BLOCK_SAMPLES * sizeof(uint32_t))  ///< Block buffer size
+
+/**
+**  PHY Playback
+**
+**  Transmitted blocks are passed from the PHY task to the playback task
+**  through a single producer single consumer queue.  Only the PHY task
+**  advances Head and only the playback task advances Tail.
+*/
+typedef struct
+{
+  volatile bool         Active;         ///< Playback in progress
+  volatile bool         Done;           ///< Stream has ended
+  bool                  Loop;           ///< Repeat file
+  bool                  Eof;            ///< End of file reached without Loop
+  bool                  StopSent;       ///< Stream disable has been requested
+  adrv9001_port_t       Port;           ///< Transmit port
+  FIL                   File;           ///< Playback file
+  bool                  Binary;         ///< File has a binary header, samples are stored I first
+  FSIZE_t               DataStart;      ///< File offset of the first sample
+  FSIZE_t               DataEnd;        ///< File offset after the last sample
+  uint32_t             *Buf;            ///< Block buffer
+  ddr_arena_region_t   *Region;         ///< DDR arena region holding the block buffer
+  uint32_t              DataBlockCnt;   ///< Number of blocks holding file data, valid once Eof is set
+  uint32_t             *Queue[PHY_PLAYBACK_QUEUE_SIZE];  ///< Transmitted blocks waiting for refill
+  uint32_t              QueueIdx[PHY_PLAYBACK_QUEUE_SIZE];  ///< Block sequence numbers of Queue
+  volatile uint32_t     Head;           ///< Next queue entry written by the PHY task
+  volatile uint32_t     Tail;           ///< Next queue entry read by the playback task
+  phy_playback_stats_t  Stats;          ///< Statistics
+  TaskHandle_t          Task;           ///< Playback task
+} phy_playback_t;
+
+static phy_playback_t PhyPlayback;
+
+static void PhyPlayback_Callback( phy_evt_type_t EvtType, phy_evt_data_t EvtData, void *param )
+{
+  if( EvtType == PhyEvtType_BlockReady )
+  {
+    PhyPlayback.Queue[ PhyPlayback.Head % PHY_PLAYBACK_QUEUE_SIZE ] = EvtData.Stream.SampleBuf;
+    PhyPlayback.QueueIdx[ PhyPlayback.Head % PHY_PLAYBACK_QUEUE_SIZE ] = EvtData.Stream.BlockIdx;
+
+    /* Publish block before advancing head */
+    __sync_synchronize();
+    PhyPlayback.Head++;
+
+    /* The transmitter runs dry after the last block of a finite file */
+    if( !PhyPlayback.Eof || ((EvtData.Stream.BlockIdx + 1) < PhyPlayback.DataBlockCnt) )
+      PhyPlayback.Stats.UnderrunCnt = EvtData.Stream.OverrunCnt;
+
+    PhyPlayback.Stats.BlockCnt++;
+  }
+  else if( EvtType == PhyEvtType_StreamDone )
+  {
+    PhyPlayback.Done = true;
+  }
+  else
+  {
+    return;
+  }
+
+  xTaskNotifyGive( PhyPlayback.Task );
+}
+
+/* Fill a block from the file, returns false once the file is exhausted */
+static bool PhyPlayback_Fill( uint32_t *Block )
+{
+  uint32_t Offset = 0;
+  UINT     Read;
+
+  if( PhyPlayback.Eof )
+    return false;
+
+  uint64_t Start = Timestamp_Get();
+
+  while( Offset < PHY_PLAYBACK_BLOCK_SAMPLES )
+  {
+    FSIZE_t Left = PhyPlayback.DataEnd - f_tell( &PhyPlayback.File );
+    UINT    Size = (PHY_PLAYBACK_BLOCK_SAMPLES - Offset) * sizeof(uint32_t);
+
+    if( Left < Size )
+      Size = (UINT)Left;
+
+    if( f_read( &PhyPlayback.File, &Block[Offset], Size, &Read ) != FR_OK )
+    {
+      PhyPlayback.Stats.ReadErrCnt++;
+      break;
+    }
+
+    if( PhyPlayback.Binary )
+    {
+      for( uint32_t i = Offset; i < (Offset + Read / sizeof(uint32_t)); i++ )
+        Block[i] = IQ_FILE_SWAP_IQ(Block[i]);
+    }
+
+    Offset += Read / sizeof(uint32_t);
+    PhyPlayback.Stats.SampleCnt += Read / sizeof(uint32_t);
+
+    if( Offset < PHY_PLAYBACK_BLOCK_SAMPLES )
+    {
+      /* Wrap to start of file */
+      if( PhyPlayback.Loop && (f_lseek( &PhyPlayback.File, PhyPlayback.DataStart ) == FR_OK) )
+      {
+        PhyPlayback.Stats.LoopCnt++;
+        continue;
+      }
+
+      break;
+    }
+  }
+
+  uint64_t Time = Timestamp_Get() - Start;
+
+  if( Time > PhyPlayback.Stats.ReadTimeMax )
+    PhyPlayback.Stats.ReadTimeMax = Time;
+
+  /* Pad final block */
+  if( Offset < PHY_PLAYBACK_BLOCK_SAMPLES )
+  {
+    if( MemDma_Fill( &Block[Offset], 0, (PHY_PLAYBACK_BLOCK_SAMPLES - Offset) * sizeof(uint32_t), NULL, NULL ) != XST_SUCCESS )
+      memset( &Block[Offset], 0, (PHY_PLAYBACK_BLOCK_SAMPLES - Offset) * sizeof(uint32_t) );
+    PhyPlayback.Eof = true;
+  }
+
+  return (Offset > 0);
+}
+
+static void PhyPlayback_Finish( void )
+{
+  f_close( &PhyPlayback.File );
+
+  DdrArena_Reset( PhyPlayback.Region );
+  PhyPlayback.Buf = NULL;
+
+  PhyPlayback.Stats.Active = false;
+  PhyPlayback.Active = false;
+}
+
+static void PhyPlayback_Task( void *pvParameters )
+{
+  for( ;; )
+  {
+    /* Wait for Block or Stream Done */
+    ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+    if( !PhyPlayback.Active )
+      continue;
+
+    while( PhyPlayback.Tail != PhyPlayback.Head )
+    {
+      uint32_t *Block = PhyPlayback.Queue[ PhyPlayback.Tail % PHY_PLAYBACK_QUEUE_SIZE ];
+      uint32_t Idx = PhyPlayback.QueueIdx[ PhyPlayback.Tail % PHY_PLAYBACK_QUEUE_SIZE ];
+
+      PhyPlayback.Tail++;
+
+      /* Refill and Return Block to DMA */
+      if( PhyPlayback_Fill( Block ) )
+      {
+        Phy_IqStreamBlockRelease( PhyPlayback.Port, Block );
+        PhyPlayback.DataBlockCnt = Idx + PHY_PLAYBACK_BLOCK_CNT + 1;
+      }
+
+      /* Stop once the last block holding file data has been transmitted */
+      if( !PhyPlayback.StopSent && PhyPlayback.Eof && ((Idx + 1) >= PhyPlayback.DataBlockCnt) )
+      {
+        if( Phy_IqStreamDisable( PhyPlayback.Port ) == PhyStatus_Success )
+          PhyPlayback.StopSent = true;
+      }
+    }
+
+    /* Close file once stream has ended */
+    if( PhyPlayback.Done )
+      PhyPlayback_Finish( );
+  }
+}
+
+phy_status_t PhyPlayback_Start( adrv9001_port_t Port, const char *Filename, bool Loop )
+{
+  phy_status_t status;
+
+  if( !PHY_IS_PORT_TX( Port ) )
+    return PhyStatus_InvalidPort;
+
+  if( Filename == NULL )
+    return PhyStatus_InvalidParameter;
+
+  if( PhyPlayback.Active )
+    return PhyStatus_Busy;
+
+  /* Allocate Block Buffer */
+  if((PhyPlayback.Buf = DdrArena_Alloc( PhyPlayback.Region, PHY_PLAYBACK_BUF_SIZE, IQ_BUF_ALIGN )) == NULL)
+    return PhyStatus_MemoryError;
+
+  /* Open File */
+  if( f_open( &PhyPlayback.File, Filename, FA_OPEN_EXISTING | FA_READ ) != FR_OK )
+  {
+    DdrArena_Reset( PhyPlayback.Region );
+    return PhyStatus_InvalidParameter;
+  }
+
+  PhyPlayback.Binary = IqFile_IsBinary( Filename );
+
+  if( PhyPlayback.Binary )
+  {
+    iq_file_hdr_t Hdr;
+
+    /* Samples follow the header */
+    if( (IqFile_ReadHdr( &PhyPlayback.File, &Hdr ) != XST_SUCCESS) ||
+        (Hdr.Format != IQ_FILE_FORMAT_CI16) || (Hdr.SampleCnt == 0) )
+    {
+      PhyPlayback_Finish( );
+      return PhyStatus_InvalidParameter;
+    }
+
+    PhyPlayback.DataStart = Hdr.HeaderSize;
+    PhyPlayback.DataEnd   = Hdr.HeaderSize + (FSIZE_t)(Hdr.SampleCnt * sizeof(uint32_t));
+  }
+  else
+  {
+    if( (f_size( &PhyPlayback.File ) < sizeof(uint32_t)) || (f_size( &PhyPlayback.File ) % sizeof(uint32_t)) )
+    {
+      PhyPlayback_Finish( );
+      return PhyStatus_InvalidParameter;
+    }
+
+    PhyPlayback.DataStart = 0;
+    PhyPlayback.DataEnd   = f_size( &PhyPlayback.File );
+  }
+
+  memset( &PhyPlayback.Stats, 0, sizeof(PhyPlayback.Stats) );
+  PhyPlayback.Port          = Port;
+  PhyPlayback.Loop          = Loop;
+  PhyPlayback.Eof           = false;
+  PhyPlayback.DataBlockCnt  = 0;
+  PhyPlayback.Head          = 0;
+  PhyPlayback.Tail          = 0;
+  PhyPlayback.Done          = false;
+  PhyPlayback.StopSent      = false;
+  PhyPlayback.Stats.Active  = true;
+  PhyPlayback.Active        = true;
+
+  /* Prefill all blocks, blocks past the end of a short file are silent */
+  for( uint32_t i = 0; i < PHY_PLAYBACK_BLOCK_CNT; i++ )
+  {
+    uint32_t *Block = &PhyPlayback.Buf[ i * PHY_PLAYBACK_BLOCK_SAMPLES ];
+
+    if( PhyPlayback_Fill( Block ) )
+      PhyPlayback.DataBlockCnt = i + 1;
+    else if( MemDma_Fill( Block, 0, PHY_PLAYBACK_BLOCK_SAMPLES * sizeof(uint32_t), NULL, NULL ) != XST_SUCCESS )
+      memset( Block, 0, PHY_PLAYBACK_BLOCK_SAMPLES * sizeof(uint32_t) );
+  }
+
+  phy_stream_t Stream = {
+      .SampleBuf  = PhyPlayback.Buf,
+      .SampleCnt  = PHY_PLAYBACK_BLOCK_SAMPLES,
+      .BlockCnt   = PHY_PLAYBACK_BLOCK_CNT,
+      .Port       = Port,
+      .Callback   = PhyPlayback_Callback,
+      .Cyclic     = false
+  };
+
+  /* Start Streaming */
+  if((status = Phy_IqStreamEnable( &Stream )) != PhyStatus_Success)
+    PhyPlayback_Finish( );
+
+  return status;
+}
+
+phy_status_t PhyPlayback_Stop( void )
+{
+  if( !PhyPlayback.Active )
+    return PhyStatus_Success;
+
+  return Phy_IqStreamDisable( PhyPlayback.Port );
+}
+
+phy_status_t PhyPlayback_GetStats( phy_playback_stats_t *Stats )
+{
+  if( Stats == NULL )
+    return PhyStatus_InvalidParameter;
+
+  taskENTER_CRITICAL();
+  *Stats = PhyPlayback.Stats;
+  taskEXIT_CRITICAL();
+
+  return PhyStatus_Success;
+}
+
+phy_status_t PhyPlayback_Initialize( void )
+{
+  memset( &PhyPlayback, 0, sizeof(PhyPlayback) );
+
+  /* Reserve Block Buffer */
+  if((PhyPlayback.Region = DdrArena_CreateRegion( "Playback", PHY_PLAYBACK_BUF_SIZE )) == NULL)
+    return PhyStatus_MemoryError;
+
+  /* Create Task */
+  if(xTaskCreate(PhyPlayback_Task, PHY_PLAYBACK_TASK_NAME, PHY_PLAYBACK_TASK_STACK_SIZE, NULL, PHY_PLAYBACK_TASK_PRIORITY, &PhyPlayback.Task) != pdPASS)
+    return PhyStatus_OsError;
+
+  return PhyStatus_Success;
+}
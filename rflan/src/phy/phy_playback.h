@@ -0,0 +1,126 @@
+#ifndef SRC_PHY_PLAYBACK_H_
+#define SRC_PHY_PLAYBACK_H_
+/***************************************************************************//**
+*  \ingroup    PHY
+*  \defgroup   PHY_PLAYBACK PHY Playback from File
+*  @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       phy_playback.h
+*
+*  \details
+*
+*  This file contains the RFLAN PHY playback interface.  A playback streams a
+*  file on the SD card to a transmit port a few blocks ahead of the DMA so the
+*  waveform length is limited by the card rather than the heap.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "phy.h"
+
+/**
+**  PHY Playback Statistics
+*/
+typedef struct{
+  bool              Active;           ///< Playback in progress
+  uint64_t          SampleCnt;        ///< Samples read from file
+  uint32_t          BlockCnt;         ///< Blocks transmitted
+  uint32_t          LoopCnt;          ///< Number of times the file wrapped
+  uint32_t          UnderrunCnt;      ///< DMA underruns, transmitter was starved
+  uint32_t          ReadErrCnt;       ///< File read errors
+  uint64_t          ReadTimeMax;      ///< Longest single block read in TIMESTAMP_FREQ_HZ ticks
+}phy_playback_stats_t;
+
+/*******************************************************************************
+*
+* \details
+*
+* This function starts playing a file to a transmit port.  The file holds raw
+* 32 bit IQ words, filenames ending in IQ_FILE_BIN_EXT are IqFile binary files
+* as written by PhyRecord_Start and the samples following the header are
+* played.  Rice coded files are not supported.  The first
+* PHY_PLAYBACK_BLOCK_CNT blocks are read before streaming starts and each
+* block is refilled from the file by the playback task once it has been
+* transmitted.  The last block is padded with zeros.  Without Loop the
+* playback stops once the end of the file has been transmitted, with Loop the
+* file is repeated until PhyPlayback_Stop is executed.
+*
+* \param[in]  Port is the transmit port
+*
+* \param[in]  Filename is the file to play
+*
+* \param[in]  Loop repeats the file continuously
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t PhyPlayback_Start( adrv9001_port_t Port, const char *Filename, bool Loop );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function stops the active playback.
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t PhyPlayback_Stop( void );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function returns the statistics of the active or last playback.
+*
+* \param[out] Stats is the statistics
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t PhyPlayback_GetStats( phy_playback_stats_t *Stats );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function initializes the PHY playback.
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t PhyPlayback_Initialize( void );
+
+#endif /* SRC_PHY_PLAYBACK_H_ */
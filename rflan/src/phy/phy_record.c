@@ -0,0 +1,327 @@
+/***************************************************************************//**
+*  \addtogroup PHY_RECORD
+*   @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       phy_record.c
+*
+*  \details    This file contains the RFLAN PHY record implementation.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "phy_record.h"
+#include "phy.h"
+#include "parameters.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "ff.h"
+#include "iq_buf.h"
+#include "ddr_arena.h"
+#include "timestamp.h"
+#include "iq_file.h"
+#include "iq_rice.h"
+#include "xstatus.h"
+
+#define PHY_RECORD_QUEUE_SIZE       (PHY_STREAM_BLOCK_MAX)    ///< Block queue size, holds every block of the stream
+#define PHY_RECORD_BUF_SIZE         (PHY_RECORD_BLOCK_CNT * PHY_RECORD_BLOCK_SAMPLES * sizeof(uint32_t))  ///< Block buffer size
+
+/**
+**  PHY Record
+**
+**  Blocks are passed from the PHY task to the record task through a single
+**  producer single consumer queue.  Only the PHY task advances Head and only
+**  the record task advances Tail.
+*/
+typedef struct
+{
+  volatile bool         Active;         ///< Record in progress
+  volatile bool         Done;           ///< Stream has ended
+  bool                  StopSent;       ///< Stream disable has been requested
+  adrv9001_port_t       Port;           ///< Receive port
+  FIL                   File;           ///< Record file
+  iq_file_stream_t      Stream;         ///< Binary file stream
+  iq_file_meta_t        Meta;           ///< Binary header fields
+  uint32_t             *Buf;            ///< Block buffer
+  ddr_arena_region_t   *Region;         ///< DDR arena region holding the block buffer
+  uint64_t              SampleCnt;      ///< Number of samples requested
+  uint64_t              BlockTime;      ///< Duration of one block in TIMESTAMP_FREQ_HZ ticks
+  uint32_t             *Queue[PHY_RECORD_QUEUE_SIZE];  ///< Blocks waiting for the writer
+  volatile uint32_t     Head;           ///< Next queue entry written by the PHY task
+  volatile uint32_t     Tail;           ///< Next queue entry read by the record task
+  phy_record_stats_t    Stats;          ///< Statistics
+  TaskHandle_t          Task;           ///< Record task
+} phy_record_t;
+
+static phy_record_t PhyRecord;
+
+static void PhyRecord_Callback( phy_evt_type_t EvtType, phy_evt_data_t EvtData, void *param )
+{
+  if( EvtType == PhyEvtType_BlockReady )
+  {
+    uint32_t Pending = PhyRecord.Head - PhyRecord.Tail + 1;
+
+    PhyRecord.Queue[ PhyRecord.Head % PHY_RECORD_QUEUE_SIZE ] = EvtData.Stream.SampleBuf;
+
+    if( PhyRecord.Head == 0 )
+      PhyRecord.Meta.StartTimestamp = EvtData.Stream.StartTimestamp;
+
+    /* Publish block before advancing head */
+    __sync_synchronize();
+    PhyRecord.Head++;
+
+    if( Pending > PhyRecord.Stats.QueueHighWater )
+      PhyRecord.Stats.QueueHighWater = Pending;
+
+    PhyRecord.Stats.OverrunCnt = EvtData.Stream.OverrunCnt;
+  }
+  else if( EvtType == PhyEvtType_StreamDone )
+  {
+    PhyRecord.Done = true;
+  }
+  else
+  {
+    return;
+  }
+
+  xTaskNotifyGive( PhyRecord.Task );
+}
+
+static void PhyRecord_Write( uint32_t *Block )
+{
+  uint64_t Remaining = PhyRecord.SampleCnt - PhyRecord.Stats.SampleCnt;
+  uint32_t Cnt = (Remaining < PHY_RECORD_BLOCK_SAMPLES) ? (uint32_t)Remaining : PHY_RECORD_BLOCK_SAMPLES;
+
+  if( Cnt == 0 )
+    return;
+
+  uint64_t Start = Timestamp_Get();
+
+  bool Error = (IqFile_StreamWrite( &PhyRecord.Stream, Block, Cnt ) != XST_SUCCESS);
+
+  uint64_t Time = Timestamp_Get() - Start;
+
+  if( Error )
+    PhyRecord.Stats.WriteErrCnt++;
+  else
+    PhyRecord.Stats.SampleCnt += Cnt;
+
+  PhyRecord.Stats.BlockCnt++;
+  PhyRecord.Stats.WriteTime += Time;
+
+  if( Time > PhyRecord.Stats.WriteTimeMax )
+    PhyRecord.Stats.WriteTimeMax = Time;
+
+  if( Time > PhyRecord.BlockTime )
+    PhyRecord.Stats.StallTime += Time - PhyRecord.BlockTime;
+}
+
+static void PhyRecord_Finish( void )
+{
+  /* Complete Header */
+  if( IqFile_StreamClose( &PhyRecord.Stream, &PhyRecord.Meta ) != XST_SUCCESS )
+    PhyRecord.Stats.WriteErrCnt++;
+
+  /* Trim preallocated space not written */
+  f_truncate( &PhyRecord.File );
+  f_close( &PhyRecord.File );
+
+  DdrArena_Reset( PhyRecord.Region );
+  PhyRecord.Buf = NULL;
+
+  PhyRecord.Stats.Active = false;
+  PhyRecord.Active = false;
+}
+
+static void PhyRecord_Task( void *pvParameters )
+{
+  for( ;; )
+  {
+    /* Wait for Block or Stream Done */
+    ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+    if( !PhyRecord.Active )
+      continue;
+
+    while( PhyRecord.Tail != PhyRecord.Head )
+    {
+      uint32_t *Block = PhyRecord.Queue[ PhyRecord.Tail % PHY_RECORD_QUEUE_SIZE ];
+
+      /* Write Block to File */
+      if( PhyRecord.Stats.WriteErrCnt == 0 )
+        PhyRecord_Write( Block );
+
+      PhyRecord.Tail++;
+
+      /* Return Block to DMA */
+      Phy_IqStreamBlockRelease( PhyRecord.Port, Block );
+
+      /* Stop once all samples are written or the file can not be written */
+      if( !PhyRecord.StopSent && ((PhyRecord.Stats.SampleCnt >= PhyRecord.SampleCnt) || (PhyRecord.Stats.WriteErrCnt > 0)) )
+      {
+        if( Phy_IqStreamDisable( PhyRecord.Port ) == PhyStatus_Success )
+          PhyRecord.StopSent = true;
+      }
+    }
+
+    /* Close file once stream has ended and all blocks are written */
+    if( PhyRecord.Done && (PhyRecord.Tail == PhyRecord.Head) )
+      PhyRecord_Finish( );
+  }
+}
+
+phy_status_t PhyRecord_Start( adrv9001_port_t Port, const char *Filename, uint64_t SampleCnt )
+{
+  phy_status_t status;
+  uint32_t SampleRate;
+  uint32_t Format;
+  uint64_t DataSize;
+  FSIZE_t FileSize;
+
+  if( !PHY_IS_PORT_RX( Port ) )
+    return PhyStatus_InvalidPort;
+
+  /* Records are always IqFile binary files */
+  if( (Filename == NULL) || !IqFile_IsBinary( Filename ) || (SampleCnt == 0) )
+    return PhyStatus_InvalidParameter;
+
+  Format = IqFile_GetFormat( Filename );
+  DataSize = SampleCnt * sizeof(uint32_t);
+
+  /* Rice coded blocks may exceed the samples by their block header */
+  if( Format == IQ_FILE_FORMAT_CI16_RICE )
+    DataSize += ((SampleCnt + IQ_RICE_BLOCK_SAMPLES - 1) / IQ_RICE_BLOCK_SAMPLES) * IQ_RICE_BLOCK_HDR_SIZE;
+
+  /* The header holds a 32 bit data size and FAT files stay below 4 GiB */
+  if( DataSize > (UINT32_MAX - sizeof(iq_file_hdr_t)) )
+    return PhyStatus_InvalidParameter;
+
+  FileSize = (FSIZE_t)(DataSize + sizeof(iq_file_hdr_t));
+
+  if( PhyRecord.Active )
+    return PhyStatus_Busy;
+
+  /* Get Block Duration */
+  if( Adrv9001_GetSampleRate( Port, &SampleRate ) != Adrv9001Status_Success )
+    return PhyStatus_Adrv9001Error;
+
+  /* Allocate Block Buffer */
+  if((PhyRecord.Buf = DdrArena_Alloc( PhyRecord.Region, PHY_RECORD_BUF_SIZE, IQ_BUF_ALIGN )) == NULL)
+    return PhyStatus_MemoryError;
+
+  /* Create and Preallocate File */
+  if( f_open( &PhyRecord.File, Filename, FA_CREATE_ALWAYS | FA_WRITE ) != FR_OK )
+  {
+    DdrArena_Reset( PhyRecord.Region );
+    return PhyStatus_InvalidParameter;
+  }
+
+  if( (f_lseek( &PhyRecord.File, FileSize ) != FR_OK) || (f_tell( &PhyRecord.File ) != FileSize) ||
+      (f_lseek( &PhyRecord.File, 0 ) != FR_OK) ||
+      (IqFile_StreamOpen( &PhyRecord.Stream, &PhyRecord.File, Format ) != XST_SUCCESS) )
+  {
+    f_close( &PhyRecord.File );
+    f_unlink( Filename );
+    DdrArena_Reset( PhyRecord.Region );
+    return PhyStatus_MemoryError;
+  }
+
+  /* Binary header fields, the start timestamp is taken from the first block */
+  PhyRecord.Meta = (iq_file_meta_t){ .Port = Port, .SampleRate = SampleRate };
+  Adrv9001_GetCarrierFrequency( Port, &PhyRecord.Meta.CarrierFreq );
+
+  memset( &PhyRecord.Stats, 0, sizeof(PhyRecord.Stats) );
+  PhyRecord.Port      = Port;
+  PhyRecord.SampleCnt = SampleCnt;
+  PhyRecord.BlockTime = ((uint64_t)PHY_RECORD_BLOCK_SAMPLES * TIMESTAMP_FREQ_HZ) / SampleRate;
+  PhyRecord.Head      = 0;
+  PhyRecord.Tail      = 0;
+  PhyRecord.Done      = false;
+  PhyRecord.StopSent  = false;
+  PhyRecord.Stats.Active = true;
+  PhyRecord.Active    = true;
+
+  phy_stream_t Stream = {
+      .SampleBuf  = PhyRecord.Buf,
+      .SampleCnt  = PHY_RECORD_BLOCK_SAMPLES,
+      .BlockCnt   = PHY_RECORD_BLOCK_CNT,
+      .Port       = Port,
+      .Callback   = PhyRecord_Callback,
+      .Cyclic     = false
+  };
+
+  /* Start Streaming */
+  if((status = Phy_IqStreamEnable( &Stream )) != PhyStatus_Success)
+  {
+    PhyRecord_Finish( );
+    f_unlink( Filename );
+  }
+
+  return status;
+}
+
+phy_status_t PhyRecord_Stop( void )
+{
+  if( !PhyRecord.Active )
+    return PhyStatus_Success;
+
+  return Phy_IqStreamDisable( PhyRecord.Port );
+}
+
+phy_status_t PhyRecord_GetStats( phy_record_stats_t *Stats )
+{
+  if( Stats == NULL )
+    return PhyStatus_InvalidParameter;
+
+  taskENTER_CRITICAL();
+  *Stats = PhyRecord.Stats;
+  taskEXIT_CRITICAL();
+
+  return PhyStatus_Success;
+}
+
+phy_status_t PhyRecord_Initialize( void )
+{
+  memset( &PhyRecord, 0, sizeof(PhyRecord) );
+
+  /* Reserve Block Buffer */
+  if((PhyRecord.Region = DdrArena_CreateRegion( "Record", PHY_RECORD_BUF_SIZE )) == NULL)
+    return PhyStatus_MemoryError;
+
+  /* Create Task */
+  if(xTaskCreate(PhyRecord_Task, PHY_RECORD_TASK_NAME, PHY_RECORD_TASK_STACK_SIZE, NULL, PHY_RECORD_TASK_PRIORITY, &PhyRecord.Task) != pdPASS)
+    return PhyStatus_OsError;
+
+  return PhyStatus_Success;
+}
@@ -0,0 +1,129 @@
+#ifndef SRC_PHY_RECORD_H_
+#define SRC_PHY_RECORD_H_
+/***************************************************************************//**
+*  \ingroup    PHY
+*  \defgroup   PHY_RECORD PHY Record to File
+*  @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       phy_record.h
+*
+*  \details
+*
+*  This file contains the RFLAN PHY record interface.  A record streams a
+*  continuous receive port directly to a file on the SD card so the capture
+*  length is limited by the card rather than the heap.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "phy.h"
+
+/**
+**  PHY Record Statistics
+*/
+typedef struct{
+  bool              Active;           ///< Record in progress
+  uint64_t          SampleCnt;        ///< Samples written to file
+  uint32_t          BlockCnt;         ///< Blocks written to file
+  uint32_t          OverrunCnt;       ///< DMA overruns, samples were dropped
+  uint32_t          WriteErrCnt;      ///< File write errors
+  uint32_t          QueueHighWater;   ///< Maximum blocks waiting for the writer
+  uint64_t          WriteTime;        ///< Total time spent writing in TIMESTAMP_FREQ_HZ ticks
+  uint64_t          WriteTimeMax;     ///< Longest single block write in TIMESTAMP_FREQ_HZ ticks
+  uint64_t          StallTime;        ///< Write time in excess of the block duration in TIMESTAMP_FREQ_HZ ticks
+}phy_record_stats_t;
+
+/*******************************************************************************
+*
+* \details
+*
+* This function starts recording a receive port to a file.  The file is
+* preallocated, the port is streamed continuously in blocks of
+* PHY_RECORD_BLOCK_SAMPLES and each block is written to the file by the
+* record task.  The file is an IqFile binary file, Filename must end in
+* IQ_FILE_BIN_EXT or IQ_FILE_RICE_EXT, otherwise PhyStatus_InvalidParameter
+* is returned.  The header is completed once the record ends.  Rice coding
+* runs in the record task and lowers the sample rate it can sustain.  The
+* record stops once SampleCnt samples are written or PhyRecord_Stop is
+* executed.
+*
+* \param[in]  Port is the receive port to record
+*
+* \param[in]  Filename is the file to create
+*
+* \param[in]  SampleCnt is the number of samples to record
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t PhyRecord_Start( adrv9001_port_t Port, const char *Filename, uint64_t SampleCnt );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function stops the active record.  Blocks already received are written
+* before the file is closed.
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t PhyRecord_Stop( void );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function returns the statistics of the active or last record.
+*
+* \param[out] Stats is the statistics
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t PhyRecord_GetStats( phy_record_stats_t *Stats );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function initializes the PHY record.
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t PhyRecord_Initialize( void );
+
+#endif /* SRC_PHY_RECORD_H_ */
@@ -0,0 +1,334 @@
+/***************************************************************************//**
+*  \addtogroup PHY_TRIGGER
+*   @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       phy_trigger.c
+*
+*  \details    This file contains the RFLAN PHY triggered capture implementation.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "phy_trigger.h"
+#include "phy.h"
+#include "parameters.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "ff.h"
+#include "iq_buf.h"
+#include "ddr_arena.h"
+#include "iq_power.h"
+#include "iq_file.h"
+#include "xstatus.h"
+
+#define PHY_TRIGGER_DMA_BLOCK_CNT   (3)       ///< Blocks that must stay available to the DMA
+#define PHY_TRIGGER_BUF_SIZE        (PHY_TRIGGER_BLOCK_CNT * PHY_TRIGGER_BLOCK_SAMPLES * sizeof(uint32_t))  ///< Block buffer size
+
+/**
+**  PHY Trigger
+**
+**  Blocks are examined in the PHY task.  Window holds the blocks kept by the
+**  capture in stream order and is only read by the trigger task once the
+**  stream has ended.
+*/
+typedef struct
+{
+  volatile bool         Active;         ///< Capture in progress
+  volatile bool         Done;           ///< Stream has ended
+  phy_trigger_cfg_t     Cfg;            ///< Configuration
+  char                  Filename[FF_FILENAME_MAX_LEN]; ///< Capture filename
+  FIL                   File;           ///< Capture file
+  bool                  Binary;         ///< File is written with a binary header
+  iq_file_stream_t      Stream;         ///< Binary file stream
+  iq_file_meta_t        Meta;           ///< Binary header fields
+  uint32_t             *Buf;            ///< Block buffer
+  ddr_arena_region_t   *Region;         ///< DDR arena region holding the block buffer
+  uint32_t             *Window[PHY_STREAM_BLOCK_MAX];  ///< Blocks held by the capture
+  uint64_t              WindowTimestamp[PHY_STREAM_BLOCK_MAX];  ///< Timestamps of the first sample of Window
+  uint32_t              WindowCnt;      ///< Number of blocks in Window
+  uint32_t              PostCnt;        ///< Post-trigger blocks still to be received
+  phy_trigger_stats_t   Stats;          ///< Statistics
+  TaskHandle_t          Task;           ///< Trigger task
+} phy_trigger_t;
+
+static phy_trigger_t PhyTrigger;
+
+static void PhyTrigger_Freeze( void )
+{
+  PhyTrigger.Stats.State = PhyTriggerState_Writing;
+
+  /* Stop stream, held blocks are not touched by the DMA */
+  Phy_IqStreamDisable( PhyTrigger.Cfg.Port );
+}
+
+static void PhyTrigger_Block( phy_evt_data_t *EvtData )
+{
+  uint32_t *Block = EvtData->Stream.SampleBuf;
+  uint64_t Sum;
+  uint32_t Peak;
+  uint32_t Mean;
+
+  PhyTrigger.Stats.BlockCnt++;
+  PhyTrigger.Stats.OverrunCnt = EvtData->Stream.OverrunCnt;
+
+  switch( PhyTrigger.Stats.State )
+  {
+    case PhyTriggerState_Armed:
+      IqPower_Block( Block, PHY_TRIGGER_BLOCK_SAMPLES, &Sum, &Peak );
+      Mean = (uint32_t)(Sum / PHY_TRIGGER_BLOCK_SAMPLES);
+
+      PhyTrigger.WindowTimestamp[ PhyTrigger.WindowCnt ] = EvtData->Stream.StartTimestamp;
+      PhyTrigger.Window[ PhyTrigger.WindowCnt++ ] = Block;
+
+      if( ((PhyTrigger.Cfg.Mode == PhyTriggerMode_Mean) ? Mean : Peak) >= PhyTrigger.Cfg.Threshold )
+      {
+        PhyTrigger.Stats.Triggered = true;
+        PhyTrigger.Stats.TriggerMean = Mean;
+        PhyTrigger.Stats.TriggerPeak = Peak;
+        PhyTrigger.Stats.TriggerTimestamp = EvtData->Stream.EndTimestamp;
+        PhyTrigger.Stats.State = PhyTriggerState_Capturing;
+
+        if((PhyTrigger.PostCnt = PhyTrigger.Cfg.PostBlockCnt) == 0)
+          PhyTrigger_Freeze( );
+      }
+      else if( PhyTrigger.WindowCnt > PhyTrigger.Cfg.PreBlockCnt )
+      {
+        /* Return oldest pre-trigger block to the DMA */
+        Phy_IqStreamBlockRelease( PhyTrigger.Cfg.Port, PhyTrigger.Window[0] );
+        PhyTrigger.WindowCnt--;
+        memmove( &PhyTrigger.Window[0], &PhyTrigger.Window[1], PhyTrigger.WindowCnt * sizeof(uint32_t*) );
+        memmove( &PhyTrigger.WindowTimestamp[0], &PhyTrigger.WindowTimestamp[1], PhyTrigger.WindowCnt * sizeof(uint64_t) );
+      }
+      break;
+
+    case PhyTriggerState_Capturing:
+      PhyTrigger.WindowTimestamp[ PhyTrigger.WindowCnt ] = EvtData->Stream.StartTimestamp;
+      PhyTrigger.Window[ PhyTrigger.WindowCnt++ ] = Block;
+
+      if( --PhyTrigger.PostCnt == 0 )
+        PhyTrigger_Freeze( );
+      break;
+
+    default:
+      /* Blocks landing while the stream stops are not part of the window */
+      Phy_IqStreamBlockRelease( PhyTrigger.Cfg.Port, Block );
+      break;
+  }
+}
+
+static void PhyTrigger_Callback( phy_evt_type_t EvtType, phy_evt_data_t EvtData, void *param )
+{
+  if( EvtType == PhyEvtType_BlockReady )
+  {
+    PhyTrigger_Block( &EvtData );
+  }
+  else if( EvtType == PhyEvtType_StreamDone )
+  {
+    PhyTrigger.Done = true;
+    xTaskNotifyGive( PhyTrigger.Task );
+  }
+}
+
+static void PhyTrigger_Task( void *pvParameters )
+{
+  UINT Written;
+
+  for( ;; )
+  {
+    /* Wait for Stream Done */
+    ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+    if( !PhyTrigger.Active || !PhyTrigger.Done )
+      continue;
+
+    /* Write frozen window in stream order */
+    if( PhyTrigger.Stats.Triggered )
+    {
+      PhyTrigger.Stats.State = PhyTriggerState_Writing;
+
+      for( uint32_t i = 0; i < PhyTrigger.WindowCnt; i++ )
+      {
+        if( PhyTrigger.Binary )
+        {
+          if( IqFile_StreamWrite( &PhyTrigger.Stream, PhyTrigger.Window[i], PHY_TRIGGER_BLOCK_SAMPLES ) != XST_SUCCESS )
+          {
+            PhyTrigger.Stats.WriteErrCnt++;
+            break;
+          }
+        }
+        else if( (f_write( &PhyTrigger.File, PhyTrigger.Window[i], PHY_TRIGGER_BLOCK_SAMPLES * sizeof(uint32_t), &Written ) != FR_OK) ||
+                 (Written != (PHY_TRIGGER_BLOCK_SAMPLES * sizeof(uint32_t))) )
+        {
+          PhyTrigger.Stats.WriteErrCnt++;
+          break;
+        }
+      }
+
+      if( PhyTrigger.WindowCnt > 0 )
+        PhyTrigger.Meta.StartTimestamp = PhyTrigger.WindowTimestamp[0];
+    }
+
+    /* Header of a binary file, also releases the stream of an empty capture */
+    if( PhyTrigger.Binary && (IqFile_StreamClose( &PhyTrigger.Stream, &PhyTrigger.Meta ) != XST_SUCCESS) )
+      PhyTrigger.Stats.WriteErrCnt++;
+
+    f_close( &PhyTrigger.File );
+
+    /* Remove empty capture */
+    if( !PhyTrigger.Stats.Triggered )
+      f_unlink( PhyTrigger.Filename );
+
+    DdrArena_Reset( PhyTrigger.Region );
+    PhyTrigger.Buf = NULL;
+
+    PhyTrigger.Stats.State = PhyTriggerState_Idle;
+    PhyTrigger.Active = false;
+  }
+}
+
+phy_status_t PhyTrigger_Start( phy_trigger_cfg_t *Cfg )
+{
+  phy_status_t status;
+
+  if( (Cfg == NULL) || (Cfg->Filename == NULL) || (strlen( Cfg->Filename ) >= FF_FILENAME_MAX_LEN) )
+    return PhyStatus_InvalidParameter;
+
+  if( !PHY_IS_PORT_RX( Cfg->Port ) )
+    return PhyStatus_InvalidPort;
+
+  if( (Cfg->PreBlockCnt + Cfg->PostBlockCnt + PHY_TRIGGER_DMA_BLOCK_CNT) > PHY_TRIGGER_BLOCK_CNT )
+    return PhyStatus_InvalidParameter;
+
+  if( PhyTrigger.Active )
+    return PhyStatus_Busy;
+
+  /* Allocate Block Buffer */
+  if((PhyTrigger.Buf = DdrArena_Alloc( PhyTrigger.Region, PHY_TRIGGER_BUF_SIZE, IQ_BUF_ALIGN )) == NULL)
+    return PhyStatus_MemoryError;
+
+  /* Create File */
+  strcpy( PhyTrigger.Filename, Cfg->Filename );
+
+  if( f_open( &PhyTrigger.File, PhyTrigger.Filename, FA_CREATE_ALWAYS | FA_WRITE ) != FR_OK )
+  {
+    DdrArena_Reset( PhyTrigger.Region );
+    return PhyStatus_InvalidParameter;
+  }
+
+  /* Binary files start with a header */
+  PhyTrigger.Binary = IqFile_IsBinary( PhyTrigger.Filename );
+
+  if( PhyTrigger.Binary && (IqFile_StreamOpen( &PhyTrigger.Stream, &PhyTrigger.File, IqFile_GetFormat( PhyTrigger.Filename ) ) != XST_SUCCESS) )
+  {
+    f_close( &PhyTrigger.File );
+    f_unlink( PhyTrigger.Filename );
+    DdrArena_Reset( PhyTrigger.Region );
+    return PhyStatus_InvalidParameter;
+  }
+
+  /* Binary header fields, the start timestamp is taken from the window */
+  PhyTrigger.Meta = (iq_file_meta_t){ .Port = Cfg->Port };
+  Adrv9001_GetSampleRate( Cfg->Port, &PhyTrigger.Meta.SampleRate );
+  Adrv9001_GetCarrierFrequency( Cfg->Port, &PhyTrigger.Meta.CarrierFreq );
+
+  memset( &PhyTrigger.Stats, 0, sizeof(PhyTrigger.Stats) );
+  PhyTrigger.Cfg          = *Cfg;
+  PhyTrigger.Cfg.Filename = PhyTrigger.Filename;
+  PhyTrigger.WindowCnt    = 0;
+  PhyTrigger.PostCnt      = 0;
+  PhyTrigger.Done         = false;
+  PhyTrigger.Stats.State  = PhyTriggerState_Armed;
+  PhyTrigger.Active       = true;
+
+  phy_stream_t Stream = {
+      .SampleBuf  = PhyTrigger.Buf,
+      .SampleCnt  = PHY_TRIGGER_BLOCK_SAMPLES,
+      .BlockCnt   = PHY_TRIGGER_BLOCK_CNT,
+      .Port       = Cfg->Port,
+      .Callback   = PhyTrigger_Callback,
+      .Cyclic     = false
+  };
+
+  /* Start Streaming */
+  if((status = Phy_IqStreamEnable( &Stream )) != PhyStatus_Success)
+  {
+    if( PhyTrigger.Binary )
+      IqFile_StreamClose( &PhyTrigger.Stream, NULL );
+
+    f_close( &PhyTrigger.File );
+    f_unlink( PhyTrigger.Filename );
+    DdrArena_Reset( PhyTrigger.Region );
+    PhyTrigger.Buf = NULL;
+    PhyTrigger.Stats.State = PhyTriggerState_Idle;
+    PhyTrigger.Active = false;
+  }
+
+  return status;
+}
+
+phy_status_t PhyTrigger_Stop( void )
+{
+  if( !PhyTrigger.Active )
+    return PhyStatus_Success;
+
+  return Phy_IqStreamDisable( PhyTrigger.Cfg.Port );
+}
+
+phy_status_t PhyTrigger_GetStats( phy_trigger_stats_t *Stats )
+{
+  if( Stats == NULL )
+    return PhyStatus_InvalidParameter;
+
+  taskENTER_CRITICAL();
+  *Stats = PhyTrigger.Stats;
+  taskEXIT_CRITICAL();
+
+  return PhyStatus_Success;
+}
+
+phy_status_t PhyTrigger_Initialize( void )
+{
+  memset( &PhyTrigger, 0, sizeof(PhyTrigger) );
+
+  /* Reserve Block Buffer */
+  if((PhyTrigger.Region = DdrArena_CreateRegion( "Trigger", PHY_TRIGGER_BUF_SIZE )) == NULL)
+    return PhyStatus_MemoryError;
+
+  /* Create Task */
+  if(xTaskCreate(PhyTrigger_Task, PHY_TRIGGER_TASK_NAME, PHY_TRIGGER_TASK_STACK_SIZE, NULL, PHY_TRIGGER_TASK_PRIORITY, &PhyTrigger.Task) != pdPASS)
+    return PhyStatus_OsError;
+
+  return PhyStatus_Success;
+}
@@ -0,0 +1,158 @@
+#ifndef SRC_PHY_TRIGGER_H_
+#define SRC_PHY_TRIGGER_H_
+/***************************************************************************//**
+*  \ingroup    PHY
+*  \defgroup   PHY_TRIGGER PHY Triggered Capture
+*  @{
+*******************************************************************************/
+/***************************************************************************//**
+*  \file       phy_trigger.h
+*
+*  \details
+*
+*  This file contains the RFLAN PHY triggered capture interface.  A receive
+*  port is streamed continuously into a ring of blocks and the power of each
+*  block is measured as it lands.  Once the power crosses a threshold the
+*  blocks surrounding the trigger are frozen and written to a file.
+*
+*  \copyright
+*
+*  Copyright 2021(c) NextGen RF Design, Inc.
+*
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*   - Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   - Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   - The use of this software may or may not infringe the patent rights of one
+*     or more patent holders.  This license does not release you from the
+*     requirement that you obtain separate licenses from these patent holders
+*     to use this software.
+*   - Use of the software either in source or binary form, must be run on or
+*     directly connected to a NextGen RF Design, Inc. product.
+*
+*  THIS SOFTWARE IS PROVIDED BY NEXTGEN RF DESIGN "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+*  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+*  EVENT SHALL NEXTGEN RF DESIGN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+*  INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+*  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "phy.h"
+
+/**
+**  PHY Trigger Mode
+*/
+typedef enum
+{
+  PhyTriggerMode_Mean         = 0,    ///< Trigger on mean power of a block
+  PhyTriggerMode_Peak         = 1,    ///< Trigger on peak power of a single sample
+} phy_trigger_mode_t;
+
+/**
+**  PHY Trigger State
+*/
+typedef enum
+{
+  PhyTriggerState_Idle        = 0,    ///< No capture in progress
+  PhyTriggerState_Armed       = 1,    ///< Waiting for trigger, pre-trigger blocks are held
+  PhyTriggerState_Capturing   = 2,    ///< Triggered, collecting post-trigger blocks
+  PhyTriggerState_Writing     = 3,    ///< Window frozen, writing to file
+} phy_trigger_state_t;
+
+/**
+**  PHY Trigger Configuration
+*/
+typedef struct{
+  adrv9001_port_t     Port;           ///< Receive port
+  const char         *Filename;       ///< File the captured window is written to
+  phy_trigger_mode_t  Mode;           ///< Trigger mode
+  uint32_t            Threshold;      ///< Power threshold, I*I + Q*Q
+  uint32_t            PreBlockCnt;    ///< Blocks kept before the trigger block
+  uint32_t            PostBlockCnt;   ///< Blocks captured after the trigger block
+}phy_trigger_cfg_t;
+
+/**
+**  PHY Trigger Statistics
+*/
+typedef struct{
+  phy_trigger_state_t State;          ///< Capture state
+  bool                Triggered;      ///< Trigger has fired
+  uint32_t            BlockCnt;       ///< Blocks examined
+  uint32_t            OverrunCnt;     ///< DMA overruns, samples were dropped
+  uint32_t            WriteErrCnt;    ///< File write errors
+  uint32_t            TriggerMean;    ///< Mean power of the trigger block
+  uint32_t            TriggerPeak;    ///< Peak power of the trigger block
+  uint64_t            TriggerTimestamp; ///< DMA end of transfer time of the trigger block
+}phy_trigger_stats_t;
+
+/*******************************************************************************
+*
+* \details
+*
+* This function arms a triggered capture.  The port is streamed in blocks of
+* PHY_TRIGGER_BLOCK_SAMPLES.  While armed the last PreBlockCnt blocks are
+* held and older blocks are returned to the DMA.  The first block whose power
+* reaches Threshold is the trigger block.  Once PostBlockCnt further blocks
+* are received the stream is stopped and the window of PreBlockCnt + 1 +
+* PostBlockCnt blocks is written to Filename, as an IqFile binary file when
+* Filename ends in IQ_FILE_BIN_EXT or IQ_FILE_RICE_EXT and as raw 32 bit IQ
+* words otherwise.
+* PreBlockCnt + PostBlockCnt must leave at least 3 of the PHY_TRIGGER_BLOCK_CNT
+* blocks for the DMA.
+*
+* \param[in]  Cfg is the capture configuration
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t PhyTrigger_Start( phy_trigger_cfg_t *Cfg );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function disarms the active capture.  A window that has already been
+* triggered is still written.
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t PhyTrigger_Stop( void );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function returns the statistics of the active or last capture.
+*
+* \param[out] Stats is the statistics
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t PhyTrigger_GetStats( phy_trigger_stats_t *Stats );
+
+/*******************************************************************************
+*
+* \details
+*
+* This function initializes the PHY triggered capture.
+*
+* \return     Status
+*
+*******************************************************************************/
+phy_status_t PhyTrigger_Initialize( void );
+
+#endif /* SRC_PHY_TRIGGER_H_ */